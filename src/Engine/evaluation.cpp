@@ -0,0 +1,156 @@
+#include "evaluation.h"
+#include "../Game/bitboard.h"
+#include <algorithm>
+#include <array>
+
+namespace Engine
+{
+static constexpr std::array<int, Game::PieceTypeCount> piece_values = {100, 320, 330, 500, 900, 0};
+
+// Tables are laid out as seen from white's side, a8 first, so they read like a board diagram
+using PieceSquareTable = std::array<int, 64>;
+
+// clang-format off
+static constexpr PieceSquareTable pawn_table = {
+     0,   0,   0,   0,   0,   0,   0,   0,
+    50,  50,  50,  50,  50,  50,  50,  50,
+    10,  10,  20,  30,  30,  20,  10,  10,
+     5,   5,  10,  25,  25,  10,   5,   5,
+     0,   0,   0,  20,  20,   0,   0,   0,
+     5,  -5, -10,   0,   0, -10,  -5,   5,
+     5,  10,  10, -20, -20,  10,  10,   5,
+     0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+static constexpr PieceSquareTable knight_table = {
+   -50, -40, -30, -30, -30, -30, -40, -50,
+   -40, -20,   0,   0,   0,   0, -20, -40,
+   -30,   0,  10,  15,  15,  10,   0, -30,
+   -30,   5,  15,  20,  20,  15,   5, -30,
+   -30,   0,  15,  20,  20,  15,   0, -30,
+   -30,   5,  10,  15,  15,  10,   5, -30,
+   -40, -20,   0,   5,   5,   0, -20, -40,
+   -50, -40, -30, -30, -30, -30, -40, -50,
+};
+
+static constexpr PieceSquareTable bishop_table = {
+   -20, -10, -10, -10, -10, -10, -10, -20,
+   -10,   0,   0,   0,   0,   0,   0, -10,
+   -10,   0,   5,  10,  10,   5,   0, -10,
+   -10,   5,   5,  10,  10,   5,   5, -10,
+   -10,   0,  10,  10,  10,  10,   0, -10,
+   -10,  10,  10,  10,  10,  10,  10, -10,
+   -10,   5,   0,   0,   0,   0,   5, -10,
+   -20, -10, -10, -10, -10, -10, -10, -20,
+};
+
+static constexpr PieceSquareTable rook_table = {
+     0,   0,   0,   0,   0,   0,   0,   0,
+     5,  10,  10,  10,  10,  10,  10,   5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+     0,   0,   0,   5,   5,   0,   0,   0,
+};
+
+static constexpr PieceSquareTable queen_table = {
+   -20, -10, -10,  -5,  -5, -10, -10, -20,
+   -10,   0,   0,   0,   0,   0,   0, -10,
+   -10,   0,   5,   5,   5,   5,   0, -10,
+    -5,   0,   5,   5,   5,   5,   0,  -5,
+     0,   0,   5,   5,   5,   5,   0,  -5,
+   -10,   5,   5,   5,   5,   5,   0, -10,
+   -10,   0,   5,   0,   0,   0,   0, -10,
+   -20, -10, -10,  -5,  -5, -10, -10, -20,
+};
+
+// Tucked away behind its pawns while there's material to attack it
+static constexpr PieceSquareTable king_middlegame_table = {
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -20, -30, -30, -40, -40, -30, -30, -20,
+   -10, -20, -20, -20, -20, -20, -20, -10,
+    20,  20,   0,   0,   0,   0,  20,  20,
+    20,  30,  10,   0,   0,  10,  30,  20,
+};
+
+// Towards the center once it's safe to come out
+static constexpr PieceSquareTable king_endgame_table = {
+   -50, -40, -30, -20, -20, -30, -40, -50,
+   -30, -20, -10,   0,   0, -10, -20, -30,
+   -30, -10,  20,  30,  30,  20, -10, -30,
+   -30, -10,  30,  40,  40,  30, -10, -30,
+   -30, -10,  30,  40,  40,  30, -10, -30,
+   -30, -10,  20,  30,  30,  20, -10, -30,
+   -30, -30,   0,   0,   0,   0, -30, -30,
+   -50, -30, -30, -30, -30, -30, -30, -50,
+};
+// clang-format on
+
+static constexpr std::array<const PieceSquareTable *, Game::PieceTypeCount - 1> tables = {
+    &pawn_table,
+    &knight_table,
+    &bishop_table,
+    &rook_table,
+    &queen_table,
+};
+
+// Game phase weights of minor pieces, rooks and queens. 24 with all of them on the board
+static constexpr std::array<int, Game::PieceTypeCount> phase_weights = {0, 1, 1, 2, 4, 0};
+static constexpr int max_phase = 24;
+
+// Index into the tables above for a piece of the given color
+[[nodiscard]] static int table_index(Game::Color color, Game::Square square)
+{
+    auto rank = Game::RankOf(square);
+    if (color == Game::Color::White)
+    {
+        rank = 7 - rank;
+    }
+
+    return rank * 8 + Game::FileOf(square);
+}
+
+int PieceValue(Game::PieceType type)
+{
+    return piece_values[static_cast<int>(type)];
+}
+
+int Evaluate(const Game::Position &position)
+{
+    // From white's point of view until the very end
+    auto score = 0;
+    auto phase = 0;
+    auto king_middlegame = 0;
+    auto king_endgame = 0;
+
+    for (auto color : {Game::Color::White, Game::Color::Black})
+    {
+        auto sign = color == Game::Color::White ? 1 : -1;
+        for (auto type = 0; type < Game::PieceTypeCount - 1; type++)
+        {
+            auto pieces = position.GetPieces(color, static_cast<Game::PieceType>(type));
+            phase += phase_weights[type] * Game::PopCount(pieces);
+            while (pieces)
+            {
+                auto square = Game::PopLsb(pieces);
+                score += sign * (piece_values[type] + (*tables[type])[table_index(color, square)]);
+            }
+        }
+
+        auto king = table_index(color, position.GetKingSquare(color));
+        king_middlegame += sign * king_middlegame_table[king];
+        king_endgame += sign * king_endgame_table[king];
+    }
+
+    // Promotions can push the phase past the starting material
+    phase = std::min(phase, max_phase);
+    score += (king_middlegame * phase + king_endgame * (max_phase - phase)) / max_phase;
+
+    return position.GetSideToMove() == Game::Color::White ? score : -score;
+}
+} // namespace Engine
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "../Game/position.h"
+
+namespace Engine
+{
+// Static evaluation in centipawns, from the point of view of the side to move. Material plus
+// piece-square tables, with the king's table blended from middlegame to endgame as pieces come off
+[[nodiscard]] int Evaluate(const Game::Position &position);
+
+// Material value of a piece type in centipawns, the king counts as nothing
+[[nodiscard]] int PieceValue(Game::PieceType type);
+} // namespace Engine
@@ -0,0 +1,707 @@
+#include "search.h"
+#include "../Game/bitboard.h"
+#include "../Game/move_generator.h"
+#include "../Game/move_list.h"
+#include "evaluation.h"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <optional>
+#include <thread>
+#include <utility>
+
+namespace Engine
+{
+// Move ordering tiers, see `SearchWorker::_ScoreMoves`. History scores stay below the killers
+constexpr int table_move_score = 2'000'000;
+constexpr int pv_move_score = 1'000'000;
+constexpr int capture_score = 100'000;
+constexpr int promotion_score = 90'000;
+constexpr int first_killer_score = 80'000;
+constexpr int second_killer_score = 79'000;
+constexpr int max_history_score = 50'000;
+
+// Time is only looked at every this many nodes, reading the clock isn't free
+constexpr std::uint64_t time_check_interval = 2048;
+// Helpers report their node counts in batches of this many, so they rarely touch the shared counter
+constexpr std::uint64_t helper_report_interval = 1024;
+
+[[nodiscard]] static bool is_in_check(const Game::Position &position)
+{
+    auto us = position.GetSideToMove();
+    return position.IsSquareAttacked(
+        position.GetKingSquare(us), Game::OppositeColor(us), position.GetOccupancy()
+    );
+}
+
+[[nodiscard]] static bool is_capture(const Game::Position &position, Game::Move move)
+{
+    return move.IsEnPassant() ||
+           (!move.IsCastle() && position.GetPieceAt(move.GetTo()).has_value());
+}
+
+// Mate scores count plies from the root, but the table is shared between positions reached at
+// different plies, so it stores them counting from the position itself
+[[nodiscard]] static int score_to_table(int score, int ply)
+{
+    if (IsMateScore(score))
+    {
+        return score > 0 ? score + ply : score - ply;
+    }
+    return score;
+}
+
+[[nodiscard]] static int score_from_table(int score, int ply)
+{
+    if (IsMateScore(score))
+    {
+        return score > 0 ? score - ply : score + ply;
+    }
+    return score;
+}
+
+// Everything one thread needs to search on its own: the position, the principal variation table
+// and the move ordering heuristics. Only the transposition table and the stop flag are shared
+class alignas(64) SearchWorker
+{
+  public:
+    SearchWorker(
+        TranspositionTable &table, std::atomic<bool> &stop,
+        std::atomic<std::uint64_t> &helper_nodes, int id
+    );
+    SearchWorker(const SearchWorker &other) = delete;
+    SearchWorker &operator=(const SearchWorker &other) = delete;
+
+    // Sets up a new search. Only the main worker gets limits, helpers stop when it does
+    void Prepare(
+        const Game::Position &position, const std::vector<Game::ZobristKey> &history,
+        std::uint64_t node_limit, std::optional<std::chrono::steady_clock::time_point> deadline
+    );
+    // The score is meaningless if the search was stopped meanwhile
+    [[nodiscard]] int SearchRoot(int depth);
+    // Iterative deepening until stopped or done with `max_depth`, for helpers
+    void RunHelper(int max_depth);
+    void ClearHistory();
+
+    // Principal variation of the last completed `SearchRoot`
+    [[nodiscard]] const std::vector<Game::Move> &GetPV() const;
+    [[nodiscard]] std::uint64_t GetNodes() const;
+
+  private:
+    using MoveScores = std::array<int, Game::MoveList::s_capacity>;
+
+    TranspositionTable &m_table;
+    std::atomic<bool> &m_stop;
+    std::atomic<std::uint64_t> &m_helper_nodes;
+    // Zero for the main worker
+    int m_id;
+    std::uint64_t m_random;
+
+    Game::Position m_position;
+    // Game history, then one hash per ply of the current line
+    std::vector<Game::ZobristKey> m_hashes;
+
+    std::uint64_t m_nodes;
+    std::uint64_t m_node_limit;
+    std::chrono::steady_clock::time_point m_deadline;
+    bool m_has_deadline;
+
+    // Triangular principal variation table: row `ply` holds the best line found from that ply
+    std::array<std::array<Game::Move, MaxPly>, MaxPly> m_pv;
+    std::array<int, MaxPly> m_pv_length;
+    // The previous iteration's principal variation, searched first in the next one
+    std::vector<Game::Move> m_previous_pv;
+    // Two quiet moves per ply that recently caused a beta cutoff
+    std::array<std::array<Game::Move, 2>, MaxPly> m_killers;
+    // How often a quiet move from/to a square pair caused a cutoff, weighted by depth
+    std::array<std::array<int, 64>, 64> m_history;
+
+    [[nodiscard]] int _Negamax(int depth, int ply, int alpha, int beta);
+    [[nodiscard]] int _Quiescence(int ply, int alpha, int beta);
+
+    // Checks the node and time limits, every few thousand nodes for the latter. Helpers only check
+    // whether the main worker stopped
+    [[nodiscard]] bool _ShouldStop();
+    [[nodiscard]] bool _IsDraw() const;
+    // Ordering scores, higher first: the transposition table's move, the previous principal
+    // variation, captures by most valuable victim and least valuable attacker, promotions,
+    // killers, then the history heuristic
+    void _ScoreMoves(
+        const Game::MoveList &moves, MoveScores &scores, int ply, Game::Move table_move
+    );
+    // xorshift64, only used to shuffle helpers' move ordering
+    [[nodiscard]] std::uint64_t _NextRandom();
+};
+
+Searcher::Searcher(std::size_t hash_mb, int thread_count)
+    : m_table(hash_mb), m_stop(false), m_helper_nodes(0)
+{
+    SetThreadCount(thread_count);
+}
+
+Searcher::~Searcher() = default;
+
+SearchResult Searcher::Search(
+    const Game::Game &game, const SearchLimits &limits, const IterationCallback &on_iteration
+)
+{
+    // Everything but the current position, which the other overload adds itself
+    const auto &hashes = game.GetHashes();
+    std::vector<Game::ZobristKey> history(hashes.begin(), hashes.end() - 1);
+
+    return Search(game.GetPosition(), std::move(history), limits, on_iteration);
+}
+
+SearchResult Searcher::Search(
+    const Game::Position &position, std::vector<Game::ZobristKey> history,
+    const SearchLimits &limits, const IterationCallback &on_iteration
+)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    m_stop.store(false, std::memory_order_relaxed);
+    m_helper_nodes.store(0, std::memory_order_relaxed);
+    m_table.NewSearch();
+
+    auto &main = *m_workers.front();
+    auto deadline = limits.time.count() > 0 ? std::optional(start + limits.time) : std::nullopt;
+    main.Prepare(position, history, limits.nodes, deadline);
+    for (std::size_t i = 1; i < m_workers.size(); i++)
+    {
+        m_workers[i]->Prepare(position, history, 0, std::nullopt);
+    }
+
+    auto elapsed = [&start]() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start
+        );
+    };
+    auto total_nodes = [this, &main]() {
+        return main.GetNodes() + m_helper_nodes.load(std::memory_order_relaxed);
+    };
+
+    SearchResult result;
+    Game::MoveList root_moves;
+    Game::GenerateLegalMoves(position, root_moves);
+    if (root_moves.IsEmpty())
+    {
+        result.score = is_in_check(position) ? -MateScore : 0;
+        return result;
+    }
+
+    // Something to play even if the first iteration doesn't finish
+    result.best_move = root_moves[0];
+    result.pv = {root_moves[0]};
+
+    auto max_depth = limits.depth > 0 ? std::min(limits.depth, MaxPly - 1) : MaxPly - 1;
+
+    std::vector<std::thread> helpers;
+    helpers.reserve(m_workers.size() - 1);
+    for (std::size_t i = 1; i < m_workers.size(); i++)
+    {
+        helpers.emplace_back([worker = m_workers[i].get(), max_depth]() {
+            worker->RunHelper(max_depth);
+        });
+    }
+
+    for (auto depth = 1; depth <= max_depth; depth++)
+    {
+        auto score = main.SearchRoot(depth);
+        // A partial iteration may not have looked at the best move yet, so it's thrown away
+        if (m_stop.load(std::memory_order_relaxed))
+        {
+            break;
+        }
+
+        result.score = score;
+        result.depth = depth;
+        result.pv = main.GetPV();
+        result.best_move = result.pv.front();
+        result.nodes = total_nodes();
+        result.time = elapsed();
+        result.hashfull = m_table.GetHashfull();
+
+        if (on_iteration)
+        {
+            on_iteration(result);
+        }
+
+        // Searching deeper won't find a shorter mate than one within the current depth
+        if (IsMateScore(score) && MateScore - std::abs(score) <= depth)
+        {
+            break;
+        }
+    }
+
+    // Helpers never finish on their own before the main worker does, unless they ran out of
+    // depth, so they're told to stop rather than waited for
+    m_stop.store(true, std::memory_order_relaxed);
+    for (auto &helper : helpers)
+    {
+        helper.join();
+    }
+
+    result.nodes = total_nodes();
+    result.time = elapsed();
+    result.hashfull = m_table.GetHashfull();
+    return result;
+}
+
+void Searcher::Stop()
+{
+    m_stop.store(true, std::memory_order_relaxed);
+}
+
+void Searcher::Clear()
+{
+    m_table.Clear();
+    for (auto &worker : m_workers)
+    {
+        worker->ClearHistory();
+    }
+}
+
+void Searcher::SetThreadCount(int thread_count)
+{
+    auto count = static_cast<std::size_t>(std::max(thread_count, 1));
+    // Existing workers keep their history tables
+    m_workers.resize(std::min(count, m_workers.size()));
+    while (m_workers.size() < count)
+    {
+        m_workers.push_back(std::make_unique<SearchWorker>(
+            m_table, m_stop, m_helper_nodes, static_cast<int>(m_workers.size())
+        ));
+    }
+}
+
+int Searcher::GetThreadCount() const
+{
+    return static_cast<int>(m_workers.size());
+}
+
+SearchWorker::SearchWorker(
+    TranspositionTable &table, std::atomic<bool> &stop, std::atomic<std::uint64_t> &helper_nodes,
+    int id
+)
+    : m_table(table),
+      m_stop(stop),
+      m_helper_nodes(helper_nodes),
+      m_id(id),
+      m_random(0x9E3779B97F4A7C15 * static_cast<std::uint64_t>(id + 1)),
+      m_nodes(0),
+      m_node_limit(0),
+      m_has_deadline(false),
+      m_pv{},
+      m_pv_length{},
+      m_killers{},
+      m_history{}
+{
+}
+
+void SearchWorker::Prepare(
+    const Game::Position &position, const std::vector<Game::ZobristKey> &history,
+    std::uint64_t node_limit, std::optional<std::chrono::steady_clock::time_point> deadline
+)
+{
+    m_position = position;
+    m_hashes = history;
+    m_hashes.push_back(position.GetHash());
+    m_nodes = 0;
+    m_node_limit = node_limit;
+    m_has_deadline = deadline.has_value();
+    m_deadline = deadline.value_or(std::chrono::steady_clock::time_point());
+    m_previous_pv.clear();
+    m_killers = {};
+    // Keep what the last search learned about quiet moves, but let this one outweigh it
+    for (auto &row : m_history)
+    {
+        for (auto &score : row)
+        {
+            score /= 2;
+        }
+    }
+}
+
+int SearchWorker::SearchRoot(int depth)
+{
+    auto score = _Negamax(depth, 0, -InfiniteScore, InfiniteScore);
+    if (!m_stop.load(std::memory_order_relaxed))
+    {
+        m_previous_pv.assign(m_pv[0].begin(), m_pv[0].begin() + m_pv_length[0]);
+    }
+    return score;
+}
+
+void SearchWorker::RunHelper(int max_depth)
+{
+    // Half of the helpers start one ply deeper than the main worker, so at any time some of them
+    // are already filling the table for the next iteration
+    for (auto depth = 1 + m_id % 2; depth <= max_depth; depth++)
+    {
+        static_cast<void>(SearchRoot(depth));
+        if (m_stop.load(std::memory_order_relaxed))
+        {
+            break;
+        }
+    }
+
+    m_helper_nodes.fetch_add(m_nodes % helper_report_interval, std::memory_order_relaxed);
+}
+
+void SearchWorker::ClearHistory()
+{
+    m_history = {};
+}
+
+const std::vector<Game::Move> &SearchWorker::GetPV() const
+{
+    return m_previous_pv;
+}
+
+std::uint64_t SearchWorker::GetNodes() const
+{
+    return m_nodes;
+}
+
+int SearchWorker::_Negamax(int depth, int ply, int alpha, int beta)
+{
+    m_pv_length[ply] = ply;
+
+    if (ply > 0 && _IsDraw())
+    {
+        return 0;
+    }
+
+    auto in_check = is_in_check(m_position);
+    // Don't stop looking in the middle of a forcing sequence
+    if (in_check)
+    {
+        depth++;
+    }
+
+    if (depth <= 0)
+    {
+        return _Quiescence(ply, alpha, beta);
+    }
+
+    if (ply >= MaxPly - 1)
+    {
+        return Evaluate(m_position);
+    }
+
+    m_nodes++;
+    if (_ShouldStop())
+    {
+        return 0;
+    }
+
+    // Outside the principal variation, an earlier search of this position that went at least as
+    // deep settles it whenever its bound is on the right side of the window. Cutting off on the
+    // principal variation would cut it short as well
+    auto pv_node = beta - alpha > 1;
+    auto entry = m_table.Probe(m_position.GetHash());
+    auto table_move = entry.has_value() ? entry->move : Game::Move();
+    if (entry.has_value() && !pv_node && entry->depth >= depth)
+    {
+        auto score = score_from_table(entry->score, ply);
+        if (entry->bound == Bound::Exact || (entry->bound == Bound::Lower && score >= beta) ||
+            (entry->bound == Bound::Upper && score <= alpha))
+        {
+            return score;
+        }
+    }
+
+    Game::MoveList moves;
+    Game::GenerateLegalMoves(m_position, moves);
+    if (moves.IsEmpty())
+    {
+        return in_check ? -MateScore + ply : 0;
+    }
+
+    MoveScores scores;
+    _ScoreMoves(moves, scores, ply, table_move);
+
+    auto original_alpha = alpha;
+    auto best = -InfiniteScore;
+    auto best_move = Game::Move();
+    for (std::size_t i = 0; i < moves.GetSize(); i++)
+    {
+        // Selection sort, one move at a time. Cutoffs tend to come early, so sorting the whole
+        // list up front would mostly be wasted
+        auto next = std::max_element(scores.begin() + i, scores.begin() + moves.GetSize());
+        auto next_index = static_cast<std::size_t>(next - scores.begin());
+        std::swap(moves[i], moves[next_index]);
+        std::swap(scores[i], scores[next_index]);
+
+        auto move = moves[i];
+        auto quiet = !is_capture(m_position, move) && !move.IsPromotion();
+
+        auto undo = m_position.DoMove(move);
+        m_hashes.push_back(m_position.GetHash());
+
+        // Principal variation search: the first move is expected to be the best, the rest only
+        // have to be proven worse with a null window, and are searched again if that fails
+        int score;
+        if (i == 0)
+        {
+            score = -_Negamax(depth - 1, ply + 1, -beta, -alpha);
+        }
+        else
+        {
+            score = -_Negamax(depth - 1, ply + 1, -alpha - 1, -alpha);
+            if (score > alpha && score < beta)
+            {
+                score = -_Negamax(depth - 1, ply + 1, -beta, -alpha);
+            }
+        }
+
+        m_hashes.pop_back();
+        m_position.UndoMove(move, undo);
+
+        if (m_stop.load(std::memory_order_relaxed))
+        {
+            return 0;
+        }
+
+        if (score > best)
+        {
+            best = score;
+            best_move = move;
+        }
+        if (score <= alpha)
+        {
+            continue;
+        }
+
+        alpha = score;
+        m_pv[ply][ply] = move;
+        std::copy(
+            m_pv[ply + 1].begin() + ply + 1,
+            m_pv[ply + 1].begin() + m_pv_length[ply + 1],
+            m_pv[ply].begin() + ply + 1
+        );
+        m_pv_length[ply] = std::max(m_pv_length[ply + 1], ply + 1);
+
+        if (alpha >= beta)
+        {
+            if (quiet)
+            {
+                if (m_killers[ply][0] != move)
+                {
+                    m_killers[ply][1] = m_killers[ply][0];
+                    m_killers[ply][0] = move;
+                }
+
+                auto &history = m_history[move.GetFrom()][move.GetTo()];
+                history = std::min(history + depth * depth, max_history_score);
+            }
+            break;
+        }
+    }
+
+    // Fail-low nodes have no best move worth remembering, every move was just as bad
+    auto bound = best >= beta            ? Bound::Lower
+                 : best > original_alpha ? Bound::Exact
+                                         : Bound::Upper;
+    m_table.Store(
+        m_position.GetHash(), bound == Bound::Upper ? Game::Move() : best_move,
+        score_to_table(best, ply), depth, bound
+    );
+
+    return best;
+}
+
+int SearchWorker::_Quiescence(int ply, int alpha, int beta)
+{
+    m_pv_length[ply] = ply;
+
+    m_nodes++;
+    if (_ShouldStop())
+    {
+        return 0;
+    }
+
+    if (ply >= MaxPly - 1)
+    {
+        return Evaluate(m_position);
+    }
+
+    // Standing pat: the side to move can usually do at least as well as the static evaluation by
+    // not capturing anything. That isn't an option when in check
+    auto in_check = is_in_check(m_position);
+    auto best = -InfiniteScore;
+    if (!in_check)
+    {
+        best = Evaluate(m_position);
+        if (best >= beta)
+        {
+            return best;
+        }
+        alpha = std::max(alpha, best);
+    }
+
+    Game::MoveList moves;
+    Game::GenerateLegalMoves(m_position, moves);
+    if (in_check && moves.IsEmpty())
+    {
+        return -MateScore + ply;
+    }
+
+    MoveScores scores;
+    _ScoreMoves(moves, scores, ply, Game::Move());
+
+    for (std::size_t i = 0; i < moves.GetSize(); i++)
+    {
+        auto next = std::max_element(scores.begin() + i, scores.begin() + moves.GetSize());
+        auto next_index = static_cast<std::size_t>(next - scores.begin());
+        std::swap(moves[i], moves[next_index]);
+        std::swap(scores[i], scores[next_index]);
+
+        auto move = moves[i];
+        if (!in_check && !is_capture(m_position, move) && !move.IsPromotion())
+        {
+            continue;
+        }
+
+        auto undo = m_position.DoMove(move);
+        m_hashes.push_back(m_position.GetHash());
+        auto score = -_Quiescence(ply + 1, -beta, -alpha);
+        m_hashes.pop_back();
+        m_position.UndoMove(move, undo);
+
+        if (m_stop.load(std::memory_order_relaxed))
+        {
+            return 0;
+        }
+
+        best = std::max(best, score);
+        if (score > alpha)
+        {
+            alpha = score;
+            if (alpha >= beta)
+            {
+                break;
+            }
+        }
+    }
+
+    return best;
+}
+
+bool SearchWorker::_ShouldStop()
+{
+    if (m_stop.load(std::memory_order_relaxed))
+    {
+        return true;
+    }
+
+    if (m_id > 0)
+    {
+        if (m_nodes % helper_report_interval == 0)
+        {
+            m_helper_nodes.fetch_add(helper_report_interval, std::memory_order_relaxed);
+        }
+        return false;
+    }
+
+    auto nodes = m_nodes + m_helper_nodes.load(std::memory_order_relaxed);
+    auto out_of_nodes = m_node_limit > 0 && nodes >= m_node_limit;
+    auto out_of_time = m_has_deadline && m_nodes % time_check_interval == 0 &&
+                       std::chrono::steady_clock::now() >= m_deadline;
+    if (out_of_nodes || out_of_time)
+    {
+        m_stop.store(true, std::memory_order_relaxed);
+        return true;
+    }
+
+    return false;
+}
+
+bool SearchWorker::_IsDraw() const
+{
+    if (m_position.GetHalfmoveClock() >= 100)
+    {
+        return true;
+    }
+
+    // Unlike the game, a single repetition is enough: whatever could be done the first time can be
+    // done again, so the line leads nowhere
+    auto current = m_hashes.size() - 1;
+    auto reversible = std::min<std::size_t>(m_position.GetHalfmoveClock(), current);
+    for (std::size_t back = 4; back <= reversible; back += 2)
+    {
+        if (m_hashes[current - back] == m_hashes[current])
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void SearchWorker::_ScoreMoves(
+    const Game::MoveList &moves, MoveScores &scores, int ply, Game::Move table_move
+)
+{
+    auto pv_move = static_cast<std::size_t>(ply) < m_previous_pv.size()
+                       ? m_previous_pv[ply]
+                       : Game::Move();
+
+    for (std::size_t i = 0; i < moves.GetSize(); i++)
+    {
+        auto move = moves[i];
+        if (move == table_move)
+        {
+            scores[i] = table_move_score;
+        }
+        else if (move == pv_move)
+        {
+            scores[i] = pv_move_score;
+        }
+        else if (is_capture(m_position, move))
+        {
+            auto victim = move.IsEnPassant() ? Game::PieceType::Pawn
+                                             : m_position.GetPieceAt(move.GetTo())->GetType();
+            auto attacker = m_position.GetPieceAt(move.GetFrom())->GetType();
+            scores[i] = capture_score + 10 * PieceValue(victim) - static_cast<int>(attacker);
+        }
+        else if (move.IsPromotion())
+        {
+            scores[i] = promotion_score + static_cast<int>(move.GetPromotionKind());
+        }
+        else if (move == m_killers[ply][0])
+        {
+            scores[i] = first_killer_score;
+        }
+        else if (move == m_killers[ply][1])
+        {
+            scores[i] = second_killer_score;
+        }
+        else
+        {
+            scores[i] = m_history[move.GetFrom()][move.GetTo()];
+        }
+    }
+
+    // Helpers break ties between quiet moves their own way, so they don't all walk the tree in
+    // the same order. Nudges stay within the history tier
+    if (m_id > 0)
+    {
+        for (std::size_t i = 0; i < moves.GetSize(); i++)
+        {
+            if (scores[i] <= max_history_score)
+            {
+                scores[i] += static_cast<int>(_NextRandom() % 1024);
+            }
+        }
+    }
+}
+
+std::uint64_t SearchWorker::_NextRandom()
+{
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 7;
+    m_random ^= m_random << 17;
+    return m_random;
+}
+} // namespace Engine
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "../Game/game.h"
+#include "../Game/move.h"
+#include "../Game/position.h"
+#include "../Game/zobrist.h"
+#include "transposition_table.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Engine
+{
+// Scores are in centipawns. A mate in n plies scores `MateScore - n` for the side delivering it
+constexpr int MateScore = 32000;
+constexpr int InfiniteScore = MateScore + 1;
+// Deepest the search ever goes, quiescence included
+constexpr int MaxPly = 128;
+// Transposition table size the searcher starts with, in megabytes
+constexpr std::size_t DefaultHashSize = 16;
+
+[[nodiscard]] constexpr bool IsMateScore(int score)
+{
+    return score >= MateScore - MaxPly || score <= -MateScore + MaxPly;
+}
+
+// Zero means no limit. Without any limits, the search only ends through `Searcher::Stop`
+struct SearchLimits
+{
+    int depth = 0;
+    std::uint64_t nodes = 0;
+    std::chrono::milliseconds time{0};
+};
+
+struct SearchResult
+{
+    // Null if the position has no legal moves
+    Game::Move best_move;
+    // From the point of view of the side to move, see `MateScore`
+    int score = 0;
+    // Of the last iteration that completed
+    int depth = 0;
+    std::uint64_t nodes = 0;
+    std::chrono::milliseconds time{0};
+    // Permille of the transposition table filled by this search
+    int hashfull = 0;
+    // Principal variation, starting with `best_move`
+    std::vector<Game::Move> pv;
+};
+
+class SearchWorker;
+
+// Negamax alpha-beta with iterative deepening, a transposition table and a quiescence search.
+// Moves are made and taken back on one position in place, nothing is copied or allocated per node.
+// With more than one thread, the search is Lazy SMP: helper threads run the same iterative
+// deepening with their own move ordering and starting depth, and only help through the shared
+// transposition table. The calling thread's search decides the result.
+// A searcher runs one search at a time, but can be reused for as many as needed, and the table
+// carries over from one to the next
+class Searcher
+{
+  public:
+    explicit Searcher(std::size_t hash_mb = DefaultHashSize, int thread_count = 1);
+    ~Searcher();
+    Searcher(const Searcher &other) = delete;
+    Searcher &operator=(const Searcher &other) = delete;
+
+    // Called with the result of every completed iteration
+    using IterationCallback = std::function<void(const SearchResult &result)>;
+
+    // `history` holds the hashes of earlier positions of the game, oldest first, so repetitions
+    // can be scored as draws. Helper threads are started and joined within the call
+    [[nodiscard]] SearchResult Search(
+        const Game::Position &position, std::vector<Game::ZobristKey> history,
+        const SearchLimits &limits, const IterationCallback &on_iteration = {}
+    );
+    // Same as above, with the position and history taken from the game
+    [[nodiscard]] SearchResult Search(
+        const Game::Game &game, const SearchLimits &limits,
+        const IterationCallback &on_iteration = {}
+    );
+
+    // Makes a running search return as soon as possible, with the result of the last completed
+    // iteration. Safe to call from any thread
+    void Stop();
+    // Forgets everything learned in earlier searches, e.g. when a new game starts
+    void Clear();
+
+    // Threads searching together, the calling one included. Not safe while a search is running
+    void SetThreadCount(int thread_count);
+    [[nodiscard]] int GetThreadCount() const;
+
+  private:
+    TranspositionTable m_table;
+    std::atomic<bool> m_stop;
+    // Helpers add their nodes up in batches, so the node limit can count them too. Kept on its
+    // own cache line, away from the stop flag every node reads
+    alignas(64) std::atomic<std::uint64_t> m_helper_nodes;
+    // The first one searches on the calling thread, the rest are helpers. Each is allocated on
+    // its own, cache line aligned, so threads never write to memory another one reads
+    std::vector<std::unique_ptr<SearchWorker>> m_workers;
+};
+} // namespace Engine
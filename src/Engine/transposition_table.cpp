@@ -0,0 +1,143 @@
+#include "transposition_table.h"
+#include <algorithm>
+#include <bit>
+
+namespace Engine
+{
+[[nodiscard]] static std::uint64_t pack(
+    Game::Move move, int score, int depth, Bound bound, std::uint8_t age
+)
+{
+    return static_cast<std::uint64_t>(move.GetRaw()) |
+           (static_cast<std::uint64_t>(static_cast<std::uint16_t>(score)) << 16) |
+           (static_cast<std::uint64_t>(depth & 0xFF) << 32) |
+           (static_cast<std::uint64_t>(bound) << 40) | (static_cast<std::uint64_t>(age) << 48);
+}
+
+[[nodiscard]] static Game::Move unpack_move(std::uint64_t data)
+{
+    return Game::Move::FromRaw(static_cast<std::uint16_t>(data));
+}
+
+[[nodiscard]] static int unpack_score(std::uint64_t data)
+{
+    return static_cast<std::int16_t>(static_cast<std::uint16_t>(data >> 16));
+}
+
+[[nodiscard]] static int unpack_depth(std::uint64_t data)
+{
+    return static_cast<int>((data >> 32) & 0xFF);
+}
+
+[[nodiscard]] static Bound unpack_bound(std::uint64_t data)
+{
+    return static_cast<Bound>((data >> 40) & 0x3);
+}
+
+[[nodiscard]] static std::uint8_t unpack_age(std::uint64_t data)
+{
+    return static_cast<std::uint8_t>(data >> 48);
+}
+
+TranspositionTable::TranspositionTable(std::size_t size_mb)
+    : m_buckets(nullptr), m_mask(0), m_age(0)
+{
+    auto count = std::bit_floor(std::max<std::size_t>(size_mb * 1024 * 1024 / sizeof(Bucket), 1));
+    m_buckets = std::make_unique<Bucket[]>(count);
+    m_mask = count - 1;
+}
+
+std::optional<TableEntry> TranspositionTable::Probe(Game::ZobristKey key) const
+{
+    const auto &bucket = m_buckets[key & m_mask];
+    for (const auto &entry : bucket.entries)
+    {
+        auto data = entry.data.load(std::memory_order_relaxed);
+        auto check = entry.check.load(std::memory_order_relaxed);
+        if ((check ^ data) == key && unpack_bound(data) != Bound::None)
+        {
+            return TableEntry{
+                unpack_move(data), unpack_score(data), unpack_depth(data), unpack_bound(data)
+            };
+        }
+    }
+
+    return std::nullopt;
+}
+
+void TranspositionTable::Store(
+    Game::ZobristKey key, Game::Move move, int score, int depth, Bound bound
+)
+{
+    auto &bucket = m_buckets[key & m_mask];
+
+    Entry *replace = nullptr;
+    auto replace_worth = 0;
+    for (auto &entry : bucket.entries)
+    {
+        auto data = entry.data.load(std::memory_order_relaxed);
+        auto check = entry.check.load(std::memory_order_relaxed);
+        if ((check ^ data) == key)
+        {
+            // A search that didn't get to a best move shouldn't erase the one found before
+            if (move == Game::Move())
+            {
+                move = unpack_move(data);
+            }
+            replace = &entry;
+            break;
+        }
+
+        // Every search an entry is out of date for counts like eight plies less depth
+        auto age = static_cast<std::uint8_t>(m_age - unpack_age(data));
+        auto worth = unpack_bound(data) == Bound::None ? -1'000 : unpack_depth(data) - 8 * age;
+        if (replace == nullptr || worth < replace_worth)
+        {
+            replace = &entry;
+            replace_worth = worth;
+        }
+    }
+
+    auto data = pack(move, score, depth, bound, m_age);
+    replace->check.store(key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::NewSearch()
+{
+    m_age++;
+}
+
+void TranspositionTable::Clear()
+{
+    for (std::size_t i = 0; i <= m_mask; i++)
+    {
+        for (auto &entry : m_buckets[i].entries)
+        {
+            entry.check.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    m_age = 0;
+}
+
+int TranspositionTable::GetHashfull() const
+{
+    // A thousand entries is enough to estimate from, and far quicker than counting them all
+    auto buckets = std::min<std::size_t>(1000 / s_bucket_size, m_mask + 1);
+    auto used = 0;
+    for (std::size_t i = 0; i < buckets; i++)
+    {
+        for (const auto &entry : m_buckets[i].entries)
+        {
+            auto data = entry.data.load(std::memory_order_relaxed);
+            if (unpack_bound(data) != Bound::None && unpack_age(data) == m_age)
+            {
+                used++;
+            }
+        }
+    }
+
+    return static_cast<int>(used * 1000 / (buckets * s_bucket_size));
+}
+} // namespace Engine
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "../Game/move.h"
+#include "../Game/zobrist.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace Engine
+{
+// How a stored score relates to the position's true score
+enum class Bound : std::uint8_t
+{
+    None,
+    Exact,
+    // The search failed high, the true score is at least this
+    Lower,
+    // The search failed low, the true score is at most this
+    Upper,
+};
+
+struct TableEntry
+{
+    // Null if the search didn't find a best move
+    Game::Move move;
+    int score;
+    int depth;
+    Bound bound;
+};
+
+// Remembers search results by position, so transpositions and re-searches at the next iteration
+// start from what is already known. Entries are grouped four to a 64-byte bucket, one cache line
+// per probe. Like `Game::PerftTable`, any number of threads can share it without locks: every
+// entry keeps its key XOR-ed with its data, so a torn write reads as a miss instead of garbage.
+class TranspositionTable
+{
+  public:
+    // Rounded down to a power of two number of buckets
+    explicit TranspositionTable(std::size_t size_mb);
+    TranspositionTable(const TranspositionTable &other) = delete;
+    TranspositionTable &operator=(const TranspositionTable &other) = delete;
+
+    [[nodiscard]] std::optional<TableEntry> Probe(Game::ZobristKey key) const;
+    // Overwrites the position's own entry if it has one. Otherwise the bucket gives up its least
+    // useful entry: the shallowest, counting entries from earlier searches as shallower still
+    void Store(Game::ZobristKey key, Game::Move move, int score, int depth, Bound bound);
+
+    // Call before every search, so entries left over from earlier ones get replaced first
+    void NewSearch();
+    // Forgets everything. Not safe while anything else uses the table
+    void Clear();
+
+    // Permille of entries written by the current search, sampled from the start of the table
+    [[nodiscard]] int GetHashfull() const;
+
+  private:
+    struct Entry
+    {
+        std::atomic<std::uint64_t> check;
+        // Bits 0-15 hold the move, 16-31 the score, 32-39 the depth, 40-41 the bound and 48-55
+        // the age
+        std::atomic<std::uint64_t> data;
+    };
+
+    static constexpr std::size_t s_bucket_size = 4;
+
+    struct alignas(64) Bucket
+    {
+        std::array<Entry, s_bucket_size> entries;
+    };
+
+    static_assert(sizeof(Bucket) == 64);
+
+    std::unique_ptr<Bucket[]> m_buckets;
+    std::size_t m_mask;
+    std::uint8_t m_age;
+};
+} // namespace Engine
@@ -1,11 +1,13 @@
 #pragma once
 
+#include "../Engine/search.h"
 #include "../Game/game.h"
 #include "../Game/move.h"
+#include "../Game/move_list.h"
 #include <imgui.h>
 #include <imgui_impl_opengl3_loader.h>
+#include <future>
 #include <optional>
-#include <vector>
 
 namespace GUI
 {
@@ -39,8 +41,18 @@ class ChessGUI
 
     // Promotion UI
     bool m_promotion_dialog_active = false;
-    Game::Move m_pending_promotion_move =
-        Game::Move(Game::Coordinates(0, 0), Game::Coordinates(0, 0));
+    Game::Move m_pending_promotion_move;
+
+    // Computer player, none for hot-seat play
+    std::optional<Game::Color> m_engine_color = std::nullopt;
+    float m_engine_think_time_s = 1.0f;
+    int m_engine_threads = 1;
+    Engine::Searcher m_searcher;
+    // Runs on its own thread so rendering doesn't stall while the engine thinks
+    std::future<Engine::SearchResult> m_engine_search;
+    // Position the running search started from, the result is dropped if the game moved on
+    Game::ZobristKey m_engine_search_hash = 0;
+    std::optional<Engine::SearchResult> m_last_engine_result = std::nullopt;
 
     // UI stuff
     float m_square_size = 64.0f;
@@ -55,7 +67,7 @@ class ChessGUI
 
     // Game state interaction state
     std::optional<Game::Coordinates> m_selected_square = std::nullopt;
-    std::vector<Game::Move> m_possible_moves_for_selected;
+    Game::MoveList m_possible_moves_for_selected;
 
     // Texture related members
     GLuint m_pieces_texture_id = 0;
@@ -74,6 +86,14 @@ class ChessGUI
     // Common move processing
     void _HandleMoveAftermath(bool move_made);
 
+    // Computer player
+    [[nodiscard]] bool _IsEngineTurn() const;
+    // Starts a search when it's the engine's turn and plays its move once it's done
+    void _UpdateEngine();
+    void _SetEngineColor(std::optional<Game::Color> color);
+    // Cancels a running search and throws its result away
+    void _StopEngine();
+
     // Coordinate conversion helpers
     ImVec2 _GetScreenPos(Game::Coordinates coords) const;
     std::optional<Game::Coordinates> _GetCoordsFromScreenPos(ImVec2 pos) const;
@@ -43,6 +43,9 @@ void ChessGUI::DisposeInstance()
 
 ChessGUI::~ChessGUI()
 {
+    // The search thread uses the searcher, which is about to go away
+    _StopEngine();
+
     if (m_pieces_texture_id != 0)
     {
         glDeleteTextures(1, &m_pieces_texture_id);
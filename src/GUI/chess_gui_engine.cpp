@@ -0,0 +1,101 @@
+#include "../Util/debug.h"
+#include "chess_gui.h"
+#include <chrono>
+#include <utility>
+#include <vector>
+
+namespace GUI
+{
+bool ChessGUI::_IsEngineTurn() const
+{
+    return m_engine_color.has_value() && m_engine_color.value() == m_game->GetCurrentPlayer() &&
+           m_game->GetState() == Game::GameState::Waiting;
+}
+
+void ChessGUI::_UpdateEngine()
+{
+    auto scope = Util::Debugger::CreateScope("ChessGUI::UpdateEngine");
+
+    if (m_engine_search.valid())
+    {
+        if (m_engine_search.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            return;
+        }
+
+        auto result = m_engine_search.get();
+        // Resigning, agreeing to a draw or switching sides all happen while the engine thinks
+        if (!_IsEngineTurn() || m_game->GetHash() != m_engine_search_hash ||
+            result.best_move == Game::Move())
+        {
+            scope.Debug("Dropping a search result that no longer applies\n");
+            return;
+        }
+
+        scope.Debug(
+            "Engine plays %s (depth %d, score %d, %llu nodes)\n",
+            result.best_move.ToString().c_str(),
+            result.depth,
+            result.score,
+            static_cast<unsigned long long>(result.nodes)
+        );
+
+        m_last_engine_result = result;
+        auto move_made = m_game->MakeMove(result.best_move);
+        _HandleMoveAftermath(move_made);
+        return;
+    }
+
+    if (!_IsEngineTurn() || m_promotion_dialog_active)
+    {
+        return;
+    }
+
+    // The search gets its own copies, the game keeps being read (and possibly changed) meanwhile
+    auto position = m_game->GetPosition();
+    const auto &hashes = m_game->GetHashes();
+    std::vector<Game::ZobristKey> history(hashes.begin(), hashes.end() - 1);
+
+    Engine::SearchLimits limits;
+    limits.time = std::chrono::milliseconds(static_cast<int>(m_engine_think_time_s * 1000.0f));
+
+    // Nothing is searching at this point, so the thread count can change safely
+    m_searcher.SetThreadCount(m_engine_threads);
+    m_engine_search_hash = position.GetHash();
+    m_engine_search = std::async(
+        std::launch::async,
+        [this, position, history = std::move(history), limits]() mutable {
+            return m_searcher.Search(position, std::move(history), limits);
+        }
+    );
+    scope.Debug("Engine started thinking\n");
+}
+
+void ChessGUI::_SetEngineColor(std::optional<Game::Color> color)
+{
+    _StopEngine();
+    m_engine_color = color;
+    m_last_engine_result = std::nullopt;
+
+    // Show the board from the human player's side
+    if (color.has_value())
+    {
+        m_is_normal_board_view = color.value() == Game::Color::Black;
+    }
+
+    m_selected_square = std::nullopt;
+    m_possible_moves_for_selected.Clear();
+}
+
+void ChessGUI::_StopEngine()
+{
+    if (!m_engine_search.valid())
+    {
+        return;
+    }
+
+    m_searcher.Stop();
+    m_engine_search.wait();
+    m_engine_search = {};
+}
+} // namespace GUI
@@ -20,6 +20,12 @@ void ChessGUI::_HandleInput()
         return;
     }
 
+    // The board is the engine's until it has moved
+    if (_IsEngineTurn())
+    {
+        return;
+    }
+
     auto mouse_pos_rel = ImGui::GetMousePos();
     auto is_mouse_over_board = false;
     auto coords_option = _GetCoordsFromScreenPos(mouse_pos_rel);
@@ -33,7 +39,7 @@ void ChessGUI::_HandleInput()
         !m_promotion_dialog_active)
     {
         auto clicked_coords = coords_option.value();
-        auto clicked_square_option = m_game->operator[](clicked_coords);
+        auto clicked_piece = m_game->operator[](clicked_coords);
 
         if (m_selected_square.has_value())
         {
@@ -42,12 +48,12 @@ void ChessGUI::_HandleInput()
 
             for (const auto &possible_move : m_possible_moves_for_selected)
             {
-                if (possible_move.to == clicked_coords)
+                if (possible_move.GetToCoordinates() == clicked_coords)
                 {
                     move_to_make = possible_move;
                     is_move_target = true;
 
-                    if (possible_move.promotionKind.has_value())
+                    if (possible_move.IsPromotion())
                     {
                         // Don't make the move immediately, activate promotion dialog instead
                         m_promotion_dialog_active = true;
@@ -86,38 +92,36 @@ void ChessGUI::_HandleInput()
                 );
 
                 // If the user clicked a diff. piece of their color, select that instead
-                if (clicked_square_option.has_value() &&
-                    clicked_square_option.value()->GetColor() == m_game->GetCurrentPlayer())
+                if (clicked_piece.has_value() &&
+                    clicked_piece->GetColor() == m_game->GetCurrentPlayer())
                 {
                     m_selected_square = clicked_coords;
-                    auto board = m_game->GetBoard();
-                    m_possible_moves_for_selected =
-                        clicked_square_option.value()->GetPossibleMoves(board);
+                    m_possible_moves_for_selected.Clear();
+                    m_game->GetLegalMoves(clicked_coords, m_possible_moves_for_selected);
                 }
                 else
                 {
                     // Clicked empty square or opponent piece - deselect
                     m_selected_square = std::nullopt;
-                    m_possible_moves_for_selected.clear();
+                    m_possible_moves_for_selected.Clear();
                 }
             }
         }
         else
         {
-            if (clicked_square_option.has_value() &&
-                clicked_square_option.value()->GetColor() == m_game->GetCurrentPlayer())
+            if (clicked_piece.has_value() &&
+                clicked_piece->GetColor() == m_game->GetCurrentPlayer())
             {
                 // Clicked on a piece of the current player's color, select it
                 m_selected_square = clicked_coords;
-                // Get valid moves for the selected piece
-                auto board = m_game->GetBoard();
-                m_possible_moves_for_selected =
-                    clicked_square_option.value()->GetPossibleMoves(board);
+                // Get legal moves for the selected piece
+                m_possible_moves_for_selected.Clear();
+                m_game->GetLegalMoves(clicked_coords, m_possible_moves_for_selected);
                 scope.Debug(
                     "Selected square: %d,%d, possible move count: %zu\n",
                     clicked_coords.GetRank(),
                     clicked_coords.GetFile(),
-                    m_possible_moves_for_selected.size()
+                    m_possible_moves_for_selected.GetSize()
                 );
             }
             else
@@ -130,7 +134,7 @@ void ChessGUI::_HandleInput()
                 );
                 // Clicked empty square or opponent piece - do nothing
                 m_selected_square = std::nullopt;
-                m_possible_moves_for_selected.clear();
+                m_possible_moves_for_selected.Clear();
             }
         }
     }
@@ -138,7 +142,7 @@ void ChessGUI::_HandleInput()
     {
         // Clicked outside the board area, deselect anything selected
         m_selected_square = std::nullopt;
-        m_possible_moves_for_selected.clear();
+        m_possible_moves_for_selected.Clear();
     }
 }
 
@@ -156,7 +160,8 @@ void ChessGUI::_HandleMoveAftermath(bool move_made)
             m_draw_proposed = false;
         }
 
-        if (m_flip_board_on_move)
+        // Against the computer, the board stays on the human player's side
+        if (m_flip_board_on_move && !m_engine_color.has_value())
         {
             m_is_normal_board_view = m_game->GetCurrentPlayer() == Game::Color::White;
             scope.Debug("Swapped board view\n");
@@ -165,6 +170,6 @@ void ChessGUI::_HandleMoveAftermath(bool move_made)
 
     // Deselect regardless of outcome
     m_selected_square = std::nullopt;
-    m_possible_moves_for_selected.clear();
+    m_possible_moves_for_selected.Clear();
 }
 } // namespace GUI
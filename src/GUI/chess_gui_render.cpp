@@ -1,17 +1,13 @@
 // for windows builds
 #define NOMINMAX
 
-#include "../Game/Piece/bishop_piece.h"
-#include "../Game/Piece/king_piece.h"
-#include "../Game/Piece/knight_piece.h"
-#include "../Game/Piece/pawn_piece.h"
 #include "../Game/Piece/piece.h"
-#include "../Game/Piece/queen_piece.h"
-#include "../Game/Piece/rook_piece.h"
 #include "../Util/debug.h"
 #include "chess_gui.h"
 #include <GLFW/glfw3.h>
 #include <algorithm>
+#include <cstdlib>
+#include <thread>
 
 namespace GUI
 {
@@ -50,27 +46,35 @@ void ChessGUI::_DrawPieces(ImDrawList &drawList)
         for (int file = 0; file < 8; ++file)
         {
             auto coords = Game::Coordinates(rank, file);
-            if (m_game->operator[](coords).has_value())
+            auto piece = m_game->operator[](coords);
+            if (piece.has_value())
             {
-                auto piece = m_game->operator[](coords).value();
-
                 // Column index in the texture (0-5)
                 int col = -1;
                 // Row index in the texture atlas (0=white, 1=black)
                 int row = -1;
 
-                if (dynamic_cast<const Game::KingPiece *>(piece))
-                    col = 0;
-                else if (dynamic_cast<const Game::QueenPiece *>(piece))
-                    col = 1;
-                else if (dynamic_cast<const Game::BishopPiece *>(piece))
-                    col = 2;
-                else if (dynamic_cast<const Game::KnightPiece *>(piece))
-                    col = 3;
-                else if (dynamic_cast<const Game::RookPiece *>(piece))
-                    col = 4;
-                else if (dynamic_cast<const Game::PawnPiece *>(piece))
-                    col = 5;
+                switch (piece->GetType())
+                {
+                    case Game::PieceType::King:
+                        col = 0;
+                        break;
+                    case Game::PieceType::Queen:
+                        col = 1;
+                        break;
+                    case Game::PieceType::Bishop:
+                        col = 2;
+                        break;
+                    case Game::PieceType::Knight:
+                        col = 3;
+                        break;
+                    case Game::PieceType::Rook:
+                        col = 4;
+                        break;
+                    case Game::PieceType::Pawn:
+                        col = 5;
+                        break;
+                }
 
                 if (piece->GetColor() == Game::Color::White)
                     row = 0;
@@ -116,7 +120,7 @@ void GUI::ChessGUI::_DrawHighlights(ImDrawList &draw_list)
         // Draw highlights for possible moves
         for (auto &move : m_possible_moves_for_selected)
         {
-            ImVec2 move_p_min = _GetScreenPos(move.to);
+            ImVec2 move_p_min = _GetScreenPos(move.GetToCoordinates());
             // Draw a circle for possible moves
             draw_list.AddCircleFilled(
                 ImVec2(move_p_min.x + m_square_size * 0.5f, move_p_min.y + m_square_size * 0.5f),
@@ -185,8 +189,8 @@ void ChessGUI::_DrawPromotionDialog()
 
             // Update the pending move with the chosen promotion kind
             Game::Move move(
-                m_pending_promotion_move.from,
-                m_pending_promotion_move.to,
+                m_pending_promotion_move.GetFrom(),
+                m_pending_promotion_move.GetTo(),
                 promotion_kind
             );
 
@@ -287,7 +291,7 @@ void ChessGUI::Render()
                 m_game->Resign();
                 m_draw_proposed = false;
                 m_selected_square = std::nullopt;
-                m_possible_moves_for_selected.clear();
+                m_possible_moves_for_selected.Clear();
             }
 
             if (m_draw_proposed)
@@ -299,7 +303,7 @@ void ChessGUI::Render()
                         m_game->Draw();
                         m_draw_proposed = false;
                         m_selected_square = std::nullopt;
-                        m_possible_moves_for_selected.clear();
+                        m_possible_moves_for_selected.Clear();
                     }
                     if (ImGui::MenuItem("Decline Draw"))
                     {
@@ -321,6 +325,30 @@ void ChessGUI::Render()
             ImGui::EndMenu();
         }
 
+        if (ImGui::BeginMenu("Computer"))
+        {
+            if (ImGui::MenuItem("Off", nullptr, !m_engine_color.has_value()))
+            {
+                _SetEngineColor(std::nullopt);
+            }
+
+            if (ImGui::MenuItem("Plays White", nullptr, m_engine_color == Game::Color::White))
+            {
+                _SetEngineColor(Game::Color::White);
+            }
+
+            if (ImGui::MenuItem("Plays Black", nullptr, m_engine_color == Game::Color::Black))
+            {
+                _SetEngineColor(Game::Color::Black);
+            }
+
+            ImGui::SliderFloat("Think Time", &m_engine_think_time_s, 0.1f, 10.0f, "%.1f s");
+            auto max_threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+            ImGui::SliderInt("Threads", &m_engine_threads, 1, max_threads);
+
+            ImGui::EndMenu();
+        }
+
         if (ImGui::BeginMenu("View"))
         {
             if (ImGui::MenuItem("Flip Board"))
@@ -369,6 +397,52 @@ void ChessGUI::Render()
             ImGui::TextColored(ImVec4(1.0f, 1.0f, 1.0f, 1.0f), "Draw by agreement");
             break;
         }
+        case Game::GameState::Checkmate: {
+            auto opposite = (m_game->GetCurrentPlayer() == Game::Color::White) ? "Black" : "White";
+            ImGui::TextColored(ImVec4(1.0f, 1.0f, 1.0f, 1.0f), "%s won by checkmate", opposite);
+            break;
+        }
+        case Game::GameState::Stalemate: {
+            ImGui::TextColored(ImVec4(1.0f, 1.0f, 1.0f, 1.0f), "Draw by stalemate");
+            break;
+        }
+        case Game::GameState::Repetition: {
+            ImGui::TextColored(ImVec4(1.0f, 1.0f, 1.0f, 1.0f), "Draw by threefold repetition");
+            break;
+        }
+        case Game::GameState::FiftyMoveRule: {
+            ImGui::TextColored(ImVec4(1.0f, 1.0f, 1.0f, 1.0f), "Draw by the fifty-move rule");
+            break;
+        }
+    }
+
+    if (m_engine_search.valid())
+    {
+        ImGui::TextColored(ImVec4(1.0f, 1.0f, 1.0f, 1.0f), "Computer is thinking...");
+    }
+    else if (m_last_engine_result.has_value())
+    {
+        const auto &result = m_last_engine_result.value();
+        if (Engine::IsMateScore(result.score))
+        {
+            auto plies = Engine::MateScore - std::abs(result.score);
+            ImGui::TextColored(
+                ImVec4(1.0f, 1.0f, 1.0f, 1.0f),
+                "Computer: depth %d, %s in %d",
+                result.depth,
+                result.score > 0 ? "mates" : "gets mated",
+                (plies + 1) / 2
+            );
+        }
+        else
+        {
+            ImGui::TextColored(
+                ImVec4(1.0f, 1.0f, 1.0f, 1.0f),
+                "Computer: depth %d, score %+.2f",
+                result.depth,
+                static_cast<float>(result.score) / 100.0f
+            );
+        }
     }
 
     // Determine the largest possible square size that fits within the window
@@ -395,6 +469,8 @@ void ChessGUI::Render()
         ImGui::TextColored(ImVec4(1, 0, 0, 1), "Error: Piece textures not loaded!");
     }
 
+    _UpdateEngine();
+
     // Draw promotion dialog if active, otherwise handle input normally
     if (m_promotion_dialog_active)
     {
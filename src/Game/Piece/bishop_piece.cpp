@@ -1,27 +1,18 @@
 #include "bishop_piece.h"
-#include <vector>
+#include "../position.h"
 
 namespace Game
 {
-BishopPiece::BishopPiece(Color color, Coordinates coords) : Piece(color, coords)
+void BishopPiece::GetPossibleMoves(
+    const Position &position, Square square, Color color, MoveList &out
+)
 {
-}
-
-std::vector<Move> BishopPiece::GetPossibleMoves(Board &board) const
-{
-    return _GetNaiveMovesInDirections(
-        board,
-        std::vector<std::array<short, 2>>{
-            {1, -1},  // top left
-            {1, 1},   // top right
-            {-1, -1}, // bottom left
-            {-1, 1},  // bottom right
-        }
+    GetMovesFromAttacks(
+        position,
+        square,
+        color,
+        BishopAttacks(square, position.GetOccupancy()),
+        out
     );
 }
-
-Piece *BishopPiece::Clone() const
-{
-    return new BishopPiece(m_color, m_coordinates);
-}
 } // namespace Game
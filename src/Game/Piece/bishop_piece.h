@@ -4,11 +4,11 @@
 
 namespace Game
 {
-class BishopPiece : public Piece
+// Movement rules for bishops. See `Piece::GetPossibleMoves`
+class BishopPiece
 {
   public:
-    BishopPiece(Color color, Coordinates coords);
-    [[nodiscard]] std::vector<Move> GetPossibleMoves(Board &board) const override;
-    [[nodiscard]] Piece *Clone() const override;
+    static void
+    GetPossibleMoves(const Position &position, Square square, Color color, MoveList &out);
 };
 } // namespace Game
@@ -4,25 +4,20 @@
 
 namespace Game
 {
-class KingPiece : public Piece
+// Movement rules for kings. See `Piece::GetPossibleMoves`
+class KingPiece
 {
   public:
-    KingPiece(Color color, Coordinates coords);
-    [[nodiscard]] std::vector<Move> GetPossibleMoves(Board &board) const override;
-    [[nodiscard]] virtual Piece *Clone() const override;
+    static void
+    GetPossibleMoves(const Position &position, Square square, Color color, MoveList &out);
 
-    [[nodiscard]] bool GetIsMated() const;
-    void SetMated();
-
-    [[nodiscard]] bool IsInCheck(Board &board) const;
+    // Whether the king of the given color is attacked right now
+    [[nodiscard]] static bool IsInCheck(const Position &position, Color color);
 
   private:
-    bool m_moved = false;
-    bool m_mated = false;
-
-    [[nodiscard]] bool _CanCastleShort(Board &board) const;
-    [[nodiscard]] bool _CanCastleLong(Board &board) const;
-
-    void _MakeMove(Board &board, Move move, bool simulate) override;
+    // Whether none of the given squares are attacked by the enemy
+    [[nodiscard]] static bool _IsPathSafe(const Position &position, Color color, Bitboard path);
+    [[nodiscard]] static bool _CanCastleShort(const Position &position, Square square, Color color);
+    [[nodiscard]] static bool _CanCastleLong(const Position &position, Square square, Color color);
 };
 } // namespace Game
@@ -4,11 +4,11 @@
 
 namespace Game
 {
-class KnightPiece : public Piece
+// Movement rules for knights. See `Piece::GetPossibleMoves`
+class KnightPiece
 {
   public:
-    KnightPiece(Color color, Coordinates coords);
-    [[nodiscard]] std::vector<Move> GetPossibleMoves(Board &board) const override;
-    [[nodiscard]] virtual Piece *Clone() const override;
+    static void
+    GetPossibleMoves(const Position &position, Square square, Color color, MoveList &out);
 };
 } // namespace Game
@@ -1,159 +1,55 @@
 #include "pawn_piece.h"
-#include "../../Util/debug.h"
-#include <vector>
+#include "../position.h"
 
 // For all intents and purposes, "up" can mean down for black.
 
 namespace Game
 {
-PawnPiece::PawnPiece(Color color, Coordinates coords) : Piece(color, coords)
+static void push_move(MoveList &out, Square from, Square to)
 {
-}
-
-std::vector<Move> PawnPiece::GetPossibleMoves(Board &board) const
-{
-    std::vector<Move> out;
-
-    if (m_en_passant_moves.size())
+    if (SquareBitboard(to) & (Rank1Bitboard | Rank8Bitboard))
     {
-        for (auto move : m_en_passant_moves)
-        {
-            out.push_back(move);
-        }
+        Move::GetPromotionMoves(from, to, out);
     }
-
-    auto rank_offset = m_color == Color::White ? 1 : -1;
-
-    auto one_up = m_coordinates + RankOffset(rank_offset);
-    if (one_up.IsValid() && !BOARD_AT(one_up).has_value())
+    else
     {
-        if (one_up.IsPromotionSquare(m_color))
-        {
-            auto moves = Move::GetPromotionMoves(m_coordinates, one_up);
-            for (auto move : moves)
-                out.push_back(move);
-        }
-        else
-        {
-            out.push_back(Move(m_coordinates, one_up));
-        }
-
-        auto two_up = one_up + RankOffset(rank_offset);
-        if (!m_moved && two_up.IsValid() && !BOARD_AT(two_up).has_value())
-        {
-            if (two_up.IsPromotionSquare(m_color))
-            {
-                auto moves = Move::GetPromotionMoves(m_coordinates, two_up);
-                for (auto move : moves)
-                    out.push_back(move);
-            }
-            else
-            {
-                out.push_back(Move(m_coordinates, two_up));
-            }
-        }
+        out.Push(Move(from, to));
     }
-
-    auto left = one_up + FileOffset(-1);
-    if (left.IsValid() && BOARD_AT(left).has_value() &&
-        BOARD_AT(left).value()->GetColor() != m_color)
-    {
-        if (left.IsPromotionSquare(m_color))
-        {
-            auto moves = Move::GetPromotionMoves(m_coordinates, left);
-            for (auto move : moves)
-                out.push_back(move);
-        }
-        else
-        {
-            out.push_back(Move(m_coordinates, left));
-        }
-    }
-
-    auto right = one_up + FileOffset(1);
-    if (right.IsValid() && BOARD_AT(right).has_value() &&
-        BOARD_AT(right).value()->GetColor() != m_color)
-    {
-        if (right.IsPromotionSquare(m_color))
-        {
-            auto moves = Move::GetPromotionMoves(m_coordinates, right);
-            for (auto move : moves)
-                out.push_back(move);
-        }
-        else
-        {
-            out.push_back(Move(m_coordinates, right));
-        }
-    }
-
-    return out;
 }
 
-Piece *PawnPiece::Clone() const
+void PawnPiece::GetPossibleMoves(
+    const Position &position, Square square, Color color, MoveList &out
+)
 {
-    auto other = new PawnPiece(m_color, m_coordinates);
-    other->m_moved = m_moved;
-    other->m_en_passant_moves = m_en_passant_moves;
-
-    return other;
-}
+    auto coordinates = Coordinates::FromSquare(square);
+    auto occupancy = position.GetOccupancy();
+    auto attacks = PawnAttacks(color, square);
 
-void PawnPiece::_MakeMove(Board &board, Move move, bool simulate)
-{
-    Piece::_MakeMove(board, move, simulate);
-
-    if (simulate)
+    auto en_passant = position.GetEnPassantSquare();
+    if (en_passant != NoSquare && (attacks & SquareBitboard(en_passant)))
     {
-        return;
+        out.Push(Move(square, en_passant, MoveFlag::EnPassant));
     }
 
-    m_moved = true;
+    auto rank_offset = color == Color::White ? 1 : -1;
+    auto start_rank = color == Color::White ? 1 : 6;
 
-    // Check if we moved 2
-    auto diff = move.to.GetRank() - move.from.GetRank();
-    if (diff == 2 || diff == -2)
+    auto one_up = coordinates + RankOffset(rank_offset);
+    if (one_up.IsValid() && !(occupancy & SquareBitboard(one_up.ToSquare())))
     {
-        // Inversion. If this is a white pawn that moved 2, it'd be a black pawn doing en passant,
-        // and vice versa
-        auto offset = m_color == Color::White ? -1 : 1;
-
-        // Check if enemy pawns can en passant ours
-        auto left = move.to + FileOffset(-1);
-        if (left.IsValid() && BOARD_AT(left).has_value())
-        {
-            auto pawn = dynamic_cast<PawnPiece *>(BOARD_AT(left).value());
-            if (pawn && pawn->GetColor() != m_color)
-            {
-                auto to = Coordinates(m_coordinates.GetRank() + offset, m_coordinates.GetFile());
-                Util::Debugger::Debug(
-                    "[PawnPiece::MakeMove] en passant left to %d,%d\n",
-                    to.GetRank(),
-                    to.GetFile()
-                );
-                pawn->m_en_passant_moves.push_back(Move(pawn->m_coordinates, to, m_coordinates));
-            }
-        }
+        push_move(out, square, one_up.ToSquare());
 
-        auto right = move.to + FileOffset(1);
-        if (right.IsValid() && BOARD_AT(right).has_value())
+        auto two_up = one_up + RankOffset(rank_offset);
+        if (coordinates.GetRank() == start_rank && !(occupancy & SquareBitboard(two_up.ToSquare())))
         {
-            auto pawn = dynamic_cast<PawnPiece *>(BOARD_AT(right).value());
-            if (pawn && pawn->GetColor() != m_color)
-            {
-                auto to = Coordinates(m_coordinates.GetRank() + offset, m_coordinates.GetFile());
-                Util::Debugger::Debug(
-                    "[PawnPiece::MakeMove] en passant right to %d,%d\n",
-                    to.GetRank(),
-                    to.GetFile()
-                );
-                pawn->m_en_passant_moves.push_back(Move(pawn->m_coordinates, to, m_coordinates));
-            }
+            out.Push(Move(square, two_up.ToSquare()));
         }
     }
-}
 
-void PawnPiece::SetEnPassantMoves(std::vector<Move> moves)
-{
-    m_en_passant_moves = moves;
+    auto captures = attacks & position.GetPieces(OppositeColor(color));
+    while (captures)
+    {
+        push_move(out, square, PopLsb(captures));
+    }
 }
 } // namespace Game
@@ -4,19 +4,11 @@
 
 namespace Game
 {
-class PawnPiece : public Piece
+// Movement rules for pawns. See `Piece::GetPossibleMoves`
+class PawnPiece
 {
   public:
-    PawnPiece(Color color, Coordinates coords);
-    [[nodiscard]] std::vector<Move> GetPossibleMoves(Board &board) const override;
-    [[nodiscard]] virtual Piece *Clone() const override;
-
-    void SetEnPassantMoves(std::vector<Move> moves);
-
-  private:
-    bool m_moved = false;
-    std::vector<Move> m_en_passant_moves;
-
-    void _MakeMove(Board &board, Move move, bool simulate) override;
+    static void
+    GetPossibleMoves(const Position &position, Square square, Color color, MoveList &out);
 };
 } // namespace Game
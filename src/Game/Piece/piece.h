@@ -1,58 +1,83 @@
 #pragma once
 
+#include "../bitboard.h"
 #include "../coordinates.h"
-#include "../move.h"
-#include <array>
-#include <optional>
-#include <vector>
-
-#define Board std::array<std::array<std::optional<::Game::Piece *>, 8>, 8>
-#define BOARD_AT(coords) board[coords.GetRank()][coords.GetFile()]
+#include "../move_list.h"
+#include <cstdint>
 
 namespace Game
 {
+class Position;
+
+enum class PieceType : std::uint8_t
+{
+    Pawn,
+    Knight,
+    Bishop,
+    Rook,
+    Queen,
+    King,
+};
+
+constexpr int PieceTypeCount = 6;
+
+// A piece is just its type and color, packed into a single byte. The packed value doubles as the
+// piece's index into `Position`'s bitboards, so it is also what the board stores per square.
+// Where a piece stands, whether it has moved and so on is all kept by `Position`.
 class Piece
 {
   public:
-    [[nodiscard]] Coordinates GetCoordinates() const;
-    void SetCoordinates(Coordinates coords);
-    [[nodiscard]] Color GetColor() const;
-
-    // Gets moves this piece can make, without accounting for much game state.
-    // For instance, this will still return moves that would put the king in check
-    // Requiring a tad bit more validation before calling MakeMove
-    [[nodiscard]] virtual std::vector<Move> GetPossibleMoves(Board &board) const = 0;
-    [[nodiscard]] virtual Piece *Clone() const = 0;
-    [[nodiscard]] std::vector<Piece *> GetSeenBy(Board &board) const;
-
-    // Generally, moves returned by `GetPossibleMoves` can be safely passed here.
-    // !! The only danger is that this does not check if the move would put the king in check !!
-    // This also performs some clean-up and game state updates (king is mated, in check, etc)
-    // Due to the complexity of checking for mate, we sometimes require to "simulate" moves on a
-    // deep-copied board. As such, the protected `_MakeMove` overload with the extra bool is what
-    // contains the true implementation. Some child pieces override that method to perform
-    // additional updates related to their own state
-    void MakeMove(Board &board, Move move)
+    constexpr Piece(PieceType type, Color color)
+        : m_raw(static_cast<std::uint8_t>(
+              static_cast<int>(color) * PieceTypeCount + static_cast<int>(type)
+          ))
     {
-        _MakeMove(board, move, false);
     }
 
-    virtual ~Piece();
+    // Every value below this is a valid piece
+    static constexpr std::uint8_t s_raw_count = 2 * PieceTypeCount;
 
-  protected:
-    Piece(Color color, Coordinates coords);
+    [[nodiscard]] static constexpr Piece FromRaw(std::uint8_t raw)
+    {
+        return Piece(raw);
+    }
+    [[nodiscard]] constexpr std::uint8_t GetRaw() const
+    {
+        return m_raw;
+    }
 
-    // Extremely useful for implementing rook+bishok+queen. Given directional offsets, it will
-    // traverse the board in that direction until it hits a piece or goes out of bounds.
-    [[nodiscard]] std::vector<Move>
-    _GetNaiveMovesInDirections(Board &board, std::vector<std::array<short, 2>> offsets) const;
+    [[nodiscard]] constexpr PieceType GetType() const
+    {
+        return static_cast<PieceType>(m_raw % PieceTypeCount);
+    }
+    [[nodiscard]] constexpr Color GetColor() const
+    {
+        return static_cast<Color>(m_raw / PieceTypeCount);
+    }
+
+    // Gets moves this piece can make from the given square, without accounting for much game
+    // state. For instance, this will still return moves that would put the king in check.
+    // `GenerateLegalMoves` is the one to use for moves that can be played. Moves are appended to
+    // `out`
+    void GetPossibleMoves(const Position &position, Square square, MoveList &out) const;
+    // Squares of the enemy pieces attacking this piece on the given square
+    [[nodiscard]] Bitboard GetSeenBy(const Position &position, Square square) const;
 
-    virtual void _MakeMove(Board &board, Move move, bool simulate);
+    bool operator==(const Piece &other) const = default;
 
-    Color m_color;
-    Coordinates m_coordinates;
+  private:
+    constexpr explicit Piece(std::uint8_t raw) : m_raw(raw)
+    {
+    }
+
+    std::uint8_t m_raw;
 };
 
-Board CloneBoard(Board &board);
-void FreeBoard(Board &board);
+static_assert(sizeof(Piece) == 1);
+
+// Turns an attack set into moves, skipping squares occupied by our own pieces. Used by everything
+// but pawns, whose captures and pushes differ
+void GetMovesFromAttacks(
+    const Position &position, Square from, Color color, Bitboard attacks, MoveList &out
+);
 } // namespace Game
@@ -4,11 +4,11 @@
 
 namespace Game
 {
-class QueenPiece : public Piece
+// Movement rules for queens. See `Piece::GetPossibleMoves`
+class QueenPiece
 {
   public:
-    QueenPiece(Color color, Coordinates coords);
-    [[nodiscard]] std::vector<Move> GetPossibleMoves(Board &board) const override;
-    [[nodiscard]] virtual Piece *Clone() const override;
+    static void
+    GetPossibleMoves(const Position &position, Square square, Color color, MoveList &out);
 };
 } // namespace Game
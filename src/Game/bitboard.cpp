@@ -0,0 +1,246 @@
+#include "bitboard.h"
+#include <array>
+#include <cassert>
+#include <vector>
+
+namespace Game
+{
+static short knight_offsets[8][2] = {
+    {2, 1}, {2, -1}, {-2, 1}, {-2, -1}, {1, 2}, {1, -2}, {-1, 2}, {-1, -2}
+};
+static short king_offsets[8][2] = {
+    {1, 0}, {1, 1}, {1, -1}, {-1, 0}, {-1, 1}, {-1, -1}, {0, 1}, {0, -1}
+};
+static short bishop_directions[4][2] = {{1, -1}, {1, 1}, {-1, -1}, {-1, 1}};
+static short rook_directions[4][2] = {{1, 0}, {-1, 0}, {0, -1}, {0, 1}};
+
+[[nodiscard]] static Bitboard step_attacks(Square square, short (&offsets)[8][2])
+{
+    Bitboard out = 0;
+    for (auto &offset : offsets)
+    {
+        auto to = Coordinates(RankOf(square) + offset[0], FileOf(square) + offset[1]);
+        if (to.IsValid())
+        {
+            out |= SquareBitboard(to.ToSquare());
+        }
+    }
+
+    return out;
+}
+
+// Walks every ray square by square. Way too slow for move generation, but it is the reference the
+// magic tables are built from
+[[nodiscard]] static Bitboard
+sliding_attacks(Square square, Bitboard occupancy, short (&directions)[4][2])
+{
+    Bitboard out = 0;
+    for (auto &direction : directions)
+    {
+        auto to = Coordinates(RankOf(square) + direction[0], FileOf(square) + direction[1]);
+        while (to.IsValid())
+        {
+            auto bitboard = SquareBitboard(to.ToSquare());
+            out |= bitboard;
+            if (occupancy & bitboard)
+            {
+                break;
+            }
+
+            to = to + Coordinates(direction[0], direction[1]);
+        }
+    }
+
+    return out;
+}
+
+// xorshift64*, only used to search for magic numbers. Fixed seeds keep startup deterministic
+class MagicRandom
+{
+  public:
+    explicit MagicRandom(std::uint64_t seed) : m_state(seed)
+    {
+    }
+
+    [[nodiscard]] std::uint64_t Next()
+    {
+        m_state ^= m_state >> 12;
+        m_state ^= m_state << 25;
+        m_state ^= m_state >> 27;
+        return m_state * 2685821657736338717ULL;
+    }
+
+    // Magics with few set bits are found much faster
+    [[nodiscard]] std::uint64_t NextSparse()
+    {
+        return Next() & Next() & Next();
+    }
+
+  private:
+    std::uint64_t m_state;
+};
+
+static void init_magics(
+    std::array<Magic, 64> &magics,
+    Bitboard *table,
+    [[maybe_unused]] std::size_t table_size,
+    short (&directions)[4][2]
+)
+{
+    static const std::uint64_t seeds[8] = {728, 10316, 55013, 32803, 12281, 15100, 16645, 255};
+
+    // Scratch space, reused across squares. 4096 is the most blocker configurations a square has
+    std::vector<Bitboard> occupancies(4096), references(4096);
+    std::vector<int> epochs(4096, 0);
+    auto current_epoch = 0;
+
+    Bitboard *next_slot = table;
+    for (Square square = 0; square < 64; square++)
+    {
+        // Edge squares never block anything further along the ray, unless we are on that edge
+        auto edges = ((Rank1Bitboard | Rank8Bitboard) & ~(Rank1Bitboard << (8 * RankOf(square)))) |
+                     ((FileABitboard | FileHBitboard) & ~(FileABitboard << FileOf(square)));
+
+        auto &magic = magics[square];
+        magic.mask = sliding_attacks(square, 0, directions) & ~edges;
+        magic.shift = 64 - PopCount(magic.mask);
+        magic.attacks = next_slot;
+
+        // Enumerate every subset of the mask (Carry-Rippler) along with its real attack set
+        std::size_t size = 0;
+        Bitboard subset = 0;
+        do
+        {
+            occupancies[size] = subset;
+            references[size] = sliding_attacks(square, subset, directions);
+            size++;
+            subset = (subset - magic.mask) & magic.mask;
+        } while (subset);
+
+        next_slot += size;
+        assert(next_slot <= table + table_size);
+
+        MagicRandom random(seeds[RankOf(square)]);
+        for (std::size_t i = 0; i < size;)
+        {
+            do
+            {
+                magic.magic = random.NextSparse();
+            } while (PopCount((magic.magic * magic.mask) >> 56) < 6);
+
+            // A collision is only a problem when two configurations need different attack sets.
+            // Epochs avoid clearing the table between attempts
+            current_epoch++;
+            for (i = 0; i < size; i++)
+            {
+                auto index = magic.GetIndex(occupancies[i]);
+                auto slot = magic.attacks + index;
+                if (epochs[index] < current_epoch)
+                {
+                    epochs[index] = current_epoch;
+                    *slot = references[i];
+                }
+                else if (*slot != references[i])
+                {
+                    break;
+                }
+            }
+        }
+    }
+}
+
+std::array<Magic, 64> SliderAttacks::s_bishop_magics;
+std::array<Magic, 64> SliderAttacks::s_rook_magics;
+std::array<Bitboard, 5248> SliderAttacks::s_bishop_table;
+std::array<Bitboard, 102400> SliderAttacks::s_rook_table;
+
+const bool SliderAttacks::s_initialized = SliderAttacks::_Initialize();
+
+bool SliderAttacks::_Initialize()
+{
+    init_magics(s_bishop_magics, s_bishop_table.data(), s_bishop_table.size(), bishop_directions);
+    init_magics(s_rook_magics, s_rook_table.data(), s_rook_table.size(), rook_directions);
+    return true;
+}
+
+// Leaper attacks never depend on occupancy, so they are computed once up front
+struct LeaperTables
+{
+    std::array<std::array<Bitboard, 64>, 2> pawn;
+    std::array<Bitboard, 64> knight;
+    std::array<Bitboard, 64> king;
+
+    LeaperTables()
+    {
+        for (Square square = 0; square < 64; square++)
+        {
+            auto bitboard = SquareBitboard(square);
+            pawn[static_cast<int>(Color::White)][square] =
+                ((bitboard & ~FileABitboard) << 7) | ((bitboard & ~FileHBitboard) << 9);
+            pawn[static_cast<int>(Color::Black)][square] =
+                ((bitboard & ~FileABitboard) >> 9) | ((bitboard & ~FileHBitboard) >> 7);
+            knight[square] = step_attacks(square, knight_offsets);
+            king[square] = step_attacks(square, king_offsets);
+        }
+    }
+};
+
+static const LeaperTables leaper_tables;
+
+Bitboard PawnAttacks(Color color, Square square)
+{
+    return leaper_tables.pawn[static_cast<int>(color)][square];
+}
+
+Bitboard KnightAttacks(Square square)
+{
+    return leaper_tables.knight[square];
+}
+
+Bitboard KingAttacks(Square square)
+{
+    return leaper_tables.king[square];
+}
+
+// Geometry between every pair of squares, used to work out pins and check blocks
+struct LineTables
+{
+    std::array<std::array<Bitboard, 64>, 64> between;
+    std::array<std::array<Bitboard, 64>, 64> line;
+
+    LineTables() : between{}, line{}
+    {
+        for (Square a = 0; a < 64; a++)
+        {
+            for (Square b = 0; b < 64; b++)
+            {
+                auto a_bitboard = SquareBitboard(a);
+                auto b_bitboard = SquareBitboard(b);
+                for (auto directions : {&bishop_directions, &rook_directions})
+                {
+                    if (a != b && (sliding_attacks(a, 0, *directions) & b_bitboard))
+                    {
+                        line[a][b] = (sliding_attacks(a, 0, *directions) &
+                                      sliding_attacks(b, 0, *directions)) |
+                                     a_bitboard | b_bitboard;
+                        between[a][b] = sliding_attacks(a, b_bitboard, *directions) &
+                                        sliding_attacks(b, a_bitboard, *directions);
+                    }
+                }
+            }
+        }
+    }
+};
+
+static const LineTables line_tables;
+
+Bitboard BetweenBitboard(Square a, Square b)
+{
+    return line_tables.between[a][b];
+}
+
+Bitboard LineBitboard(Square a, Square b)
+{
+    return line_tables.line[a][b];
+}
+} // namespace Game
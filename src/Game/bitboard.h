@@ -0,0 +1,114 @@
+#pragma once
+
+#include "coordinates.h"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace Game
+{
+// One bit per square, see `Square` for the layout
+using Bitboard = std::uint64_t;
+
+constexpr Bitboard FileABitboard = 0x0101010101010101ULL;
+constexpr Bitboard FileHBitboard = FileABitboard << 7;
+constexpr Bitboard Rank1Bitboard = 0xFFULL;
+constexpr Bitboard Rank8Bitboard = Rank1Bitboard << 56;
+
+[[nodiscard]] constexpr Bitboard SquareBitboard(Square square)
+{
+    return Bitboard(1) << square;
+}
+
+[[nodiscard]] constexpr int PopCount(Bitboard bitboard)
+{
+    return std::popcount(bitboard);
+}
+
+// Undefined for an empty bitboard
+[[nodiscard]] constexpr Square Lsb(Bitboard bitboard)
+{
+    return static_cast<Square>(std::countr_zero(bitboard));
+}
+
+// Removes and returns the least significant square. Undefined for an empty bitboard
+constexpr Square PopLsb(Bitboard &bitboard)
+{
+    auto square = Lsb(bitboard);
+    bitboard &= bitboard - 1;
+    return square;
+}
+
+// "Fancy" magic bitboard entry for one square. Multiplying the relevant blockers by the magic
+// number maps every blocker configuration onto a unique slot of the attack table.
+struct Magic
+{
+    // Squares whose occupancy matters, i.e. the rays without their last square
+    Bitboard mask;
+    Bitboard magic;
+    Bitboard *attacks;
+    unsigned shift;
+
+    [[nodiscard]] std::size_t GetIndex(Bitboard occupancy) const
+    {
+        return ((occupancy & mask) * magic) >> shift;
+    }
+};
+
+// Precomputed slider attack tables. They are filled in (and the magic numbers searched for) once,
+// during static initialization, after which every lookup is a multiply, a shift and a load.
+class SliderAttacks
+{
+  public:
+    SliderAttacks() = delete;
+    SliderAttacks(const SliderAttacks &) = delete;
+    SliderAttacks &operator=(const SliderAttacks &) = delete;
+
+    [[nodiscard]] static Bitboard Bishop(Square square, Bitboard occupancy)
+    {
+        auto &magic = s_bishop_magics[square];
+        return magic.attacks[magic.GetIndex(occupancy)];
+    }
+
+    [[nodiscard]] static Bitboard Rook(Square square, Bitboard occupancy)
+    {
+        auto &magic = s_rook_magics[square];
+        return magic.attacks[magic.GetIndex(occupancy)];
+    }
+
+  private:
+    static std::array<Magic, 64> s_bishop_magics;
+    static std::array<Magic, 64> s_rook_magics;
+    // Sum over all squares of 2^(relevant bits)
+    static std::array<Bitboard, 5248> s_bishop_table;
+    static std::array<Bitboard, 102400> s_rook_table;
+
+    static const bool s_initialized;
+    [[nodiscard]] static bool _Initialize();
+};
+
+// Attack sets. These include squares occupied by either side; callers mask out their own pieces
+[[nodiscard]] Bitboard PawnAttacks(Color color, Square square);
+[[nodiscard]] Bitboard KnightAttacks(Square square);
+[[nodiscard]] Bitboard KingAttacks(Square square);
+
+// Squares strictly between two squares sharing a rank, file or diagonal, empty otherwise
+[[nodiscard]] Bitboard BetweenBitboard(Square a, Square b);
+// The whole rank, file or diagonal going through both squares, empty if there is none
+[[nodiscard]] Bitboard LineBitboard(Square a, Square b);
+
+// Sliders stop at (and include) the first occupied square in every direction
+[[nodiscard]] inline Bitboard BishopAttacks(Square square, Bitboard occupancy)
+{
+    return SliderAttacks::Bishop(square, occupancy);
+}
+[[nodiscard]] inline Bitboard RookAttacks(Square square, Bitboard occupancy)
+{
+    return SliderAttacks::Rook(square, occupancy);
+}
+[[nodiscard]] inline Bitboard QueenAttacks(Square square, Bitboard occupancy)
+{
+    return BishopAttacks(square, occupancy) | RookAttacks(square, occupancy);
+}
+} // namespace Game
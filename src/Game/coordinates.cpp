@@ -1,5 +1,5 @@
 #include "coordinates.h"
-#include "format"
+#include "notation.h"
 
 namespace Game
 {
@@ -7,6 +7,11 @@ Coordinates::Coordinates(short rank, short file) : m_rank(rank), m_file(file)
 {
 }
 
+Coordinates Coordinates::FromSquare(Square square)
+{
+    return Coordinates(RankOf(square), FileOf(square));
+}
+
 short Coordinates::GetRank() const
 {
     return m_rank;
@@ -15,15 +20,16 @@ short Coordinates::GetFile() const
 {
     return m_file;
 }
+Square Coordinates::ToSquare() const
+{
+    return MakeSquare(m_rank, m_file);
+}
 
 std::string Coordinates::ToString() const
 {
-    static const char file_names[8] = {'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H'};
-    static const char rank_names[8] = {'1', '2', '3', '4', '5', '6', '7', '8'};
-
-    auto file = file_names[m_file];
-    auto rank = rank_names[m_rank];
-    return std::format("{}{}", file, rank);
+    char buffer[Notation::MaxSquareLength];
+    auto end = Notation::WriteSquare(buffer, buffer + sizeof(buffer), ToSquare()).ptr;
+    return std::string(buffer, end);
 }
 
 bool Coordinates::IsValid() const
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 namespace Game
@@ -10,6 +11,29 @@ enum class Color
     Black,
 };
 
+[[nodiscard]] constexpr Color OppositeColor(Color color)
+{
+    return color == Color::White ? Color::Black : Color::White;
+}
+
+// Squares are indexed rank-major, from A1 (0) to H8 (63). This matches the bit layout of a
+// Bitboard, so a square doubles as a bit index.
+using Square = std::uint8_t;
+constexpr Square NoSquare = 64;
+
+[[nodiscard]] constexpr Square MakeSquare(int rank, int file)
+{
+    return static_cast<Square>(rank * 8 + file);
+}
+[[nodiscard]] constexpr int RankOf(Square square)
+{
+    return square >> 3;
+}
+[[nodiscard]] constexpr int FileOf(Square square)
+{
+    return square & 7;
+}
+
 struct RankOffset
 {
    short value;
@@ -24,9 +48,14 @@ class Coordinates
   public:
     Coordinates(short rank, short file);
 
+    [[nodiscard]] static Coordinates FromSquare(Square square);
+
     [[nodiscard]] short GetRank() const;
     [[nodiscard]] short GetFile() const;
+    // Only meaningful for valid coordinates
+    [[nodiscard]] Square ToSquare() const;
 
+    // e.g. "e4", see `Notation::WriteSquare` for the allocation-free version
     [[nodiscard]] std::string ToString() const;
 
     [[nodiscard]] bool IsValid() const;
@@ -1,79 +1,230 @@
 #include "game.h"
 #include "../Util/debug.h"
-#include "Piece/bishop_piece.h"
 #include "Piece/king_piece.h"
-#include "Piece/knight_piece.h"
-#include "Piece/pawn_piece.h"
-#include "Piece/piece.h"
-#include "Piece/queen_piece.h"
-#include "Piece/rook_piece.h"
-#include <optional>
+#include "move_generator.h"
+#include "notation.h"
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <ostream>
 
 namespace Game
 {
-[[nodiscard]] static std::array<Piece *, 8> get_pieces(Color color)
+Game::Game() : Game(Position::StartingPosition())
 {
-    std::array<Piece *, 8> pieces;
-
-    auto rank = color == Color::White ? 0 : 7;
-
-    pieces[0] = new RookPiece(color, Coordinates(rank, 0), RookKind::Long);
-    pieces[1] = new KnightPiece(color, Coordinates(rank, 1));
-    pieces[2] = new BishopPiece(color, Coordinates(rank, 2));
-    pieces[3] = new QueenPiece(color, Coordinates(rank, 3));
-    pieces[4] = new KingPiece(color, Coordinates(rank, 4));
-    pieces[5] = new BishopPiece(color, Coordinates(rank, 5));
-    pieces[6] = new KnightPiece(color, Coordinates(rank, 6));
-    pieces[7] = new RookPiece(color, Coordinates(rank, 7), RookKind::Short);
+}
 
-    return pieces;
+Game::Game(const Position &position)
+    : m_state(GameState::Waiting),
+      m_position(position),
+      m_starting_position(position),
+      m_hashes{m_position.GetHash()}
+{
+    m_state = _EvaluateState();
 }
 
-Game::Game() : m_current_player(Color::White), m_state(GameState::Waiting)
+Game::~Game() = default;
+
+std::unique_ptr<Game> Game::FromFEN(std::string_view fen)
 {
-    auto white_pieces = get_pieces(Color::White);
-    for (auto file = 0; file < 8; file++)
+    auto position = Position::FromFEN(fen);
+    if (!position.has_value())
     {
-        m_board[0][file] = white_pieces[file];
-        m_board[1][file] = new PawnPiece(Color::White, Coordinates(1, file));
+        return nullptr;
     }
-    auto black_pieces = get_pieces(Color::Black);
-    for (auto file = 0; file < 8; file++)
+
+    return std::make_unique<Game>(position.value());
+}
+
+Color Game::GetCurrentPlayer() const
+{
+    return m_position.GetSideToMove();
+}
+
+GameState Game::GetState() const
+{
+    return m_state;
+}
+
+const Position &Game::GetPosition() const
+{
+    return m_position;
+}
+
+PositionSnapshot Game::GetSnapshot() const
+{
+    return PositionSnapshot(m_position);
+}
+
+const Position &Game::GetStartingPosition() const
+{
+    return m_starting_position;
+}
+
+const std::vector<Move> &Game::GetMoves() const
+{
+    return m_moves;
+}
+
+const std::vector<ZobristKey> &Game::GetHashes() const
+{
+    return m_hashes;
+}
+
+ZobristKey Game::GetHash() const
+{
+    return m_position.GetHash();
+}
+
+std::string Game::ToFEN() const
+{
+    return m_position.ToFEN();
+}
+
+// Games starting from here don't need a FEN tag
+constexpr std::string_view starting_fen =
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// Result as written at the end of PGN movetext
+[[nodiscard]] static std::string_view pgn_result(GameState state, Color to_move)
+{
+    switch (state)
     {
-        m_board[7][file] = black_pieces[file];
-        m_board[6][file] = new PawnPiece(Color::Black, Coordinates(6, file));
+        case GameState::Waiting:
+            return "*";
+        // Whoever is to move either resigned or got mated
+        case GameState::Ended:
+        case GameState::Checkmate:
+            return to_move == Color::White ? "0-1" : "1-0";
+        case GameState::Draw:
+        case GameState::Stalemate:
+        case GameState::Repetition:
+        case GameState::FiftyMoveRule:
+            return "1/2-1/2";
     }
+
+    return "*";
 }
 
-Game::~Game()
+static void append_tag(std::string &text, std::string_view name, std::string_view value)
 {
-    for (auto rank = 0; rank < 8; rank++)
+    text += '[';
+    text += name;
+    text += " \"";
+    for (auto c : value)
     {
-        for (auto file = 0; file < 8; file++)
+        if (c == '"' || c == '\\')
         {
-            auto piece = m_board[rank][file];
-            if (piece.has_value())
-            {
-                delete piece.value();
-                m_board[rank][file] = std::nullopt;
-            }
+            text += '\\';
         }
+        text += c;
     }
+    text += "\"]\n";
 }
 
-Color Game::GetCurrentPlayer() const
+// Adds a movetext token, wrapping lines before they reach 80 characters as the export format asks
+static void append_movetext(std::string &text, std::size_t &line_length, std::string_view token)
 {
-    return m_current_player;
+    if (line_length > 0 && line_length + 1 + token.size() >= 80)
+    {
+        text += '\n';
+        line_length = 0;
+    }
+    else if (line_length > 0)
+    {
+        text += ' ';
+        line_length++;
+    }
+
+    text += token;
+    line_length += token.size();
 }
 
-GameState Game::GetState() const
+void Game::WritePGN(std::ostream &out, std::span<const PgnTag> tags) const
 {
-    return m_state;
+    auto find_tag = [&tags](std::string_view name) -> std::optional<std::string_view> {
+        for (const auto &tag : tags)
+        {
+            if (tag.name == name)
+            {
+                return tag.value;
+            }
+        }
+
+        return std::nullopt;
+    };
+
+    auto result = find_tag("Result").value_or(pgn_result(m_state, GetCurrentPlayer()));
+
+    // Built up in memory and written in one go, streams are slow at many small writes
+    std::string text;
+    static constexpr std::string_view roster[] = {
+        "Event", "Site", "Date", "Round", "White", "Black"
+    };
+    for (auto name : roster)
+    {
+        append_tag(text, name, find_tag(name).value_or(name == "Date" ? "????.??.??" : "?"));
+    }
+    append_tag(text, "Result", result);
+
+    char fen[Notation::MaxFENLength];
+    auto fen_end = Notation::WriteFEN(fen, fen + sizeof(fen), m_starting_position).ptr;
+    std::string_view start_fen(fen, static_cast<std::size_t>(fen_end - fen));
+    if (start_fen != starting_fen)
+    {
+        append_tag(text, "SetUp", "1");
+        append_tag(text, "FEN", start_fen);
+    }
+
+    for (const auto &tag : tags)
+    {
+        auto in_roster = std::find(std::begin(roster), std::end(roster), tag.name);
+        auto written = in_roster != std::end(roster) || tag.name == "Result" ||
+                       tag.name == "SetUp" || tag.name == "FEN";
+        if (!written)
+        {
+            append_tag(text, tag.name, tag.value);
+        }
+    }
+    text += '\n';
+
+    // Replayed from the start, SAN needs the position each move was played in
+    auto position = m_starting_position;
+    std::size_t line_length = 0;
+    for (std::size_t i = 0; i < m_moves.size(); i++)
+    {
+        auto white = position.GetSideToMove() == Color::White;
+        // Room for "65535..."
+        char token[Notation::MaxSANLength + 3];
+        if (white || i == 0)
+        {
+            auto number = position.GetFullmoveNumber();
+            auto end = std::to_chars(token, token + sizeof(token), number).ptr;
+            end = std::copy_n("...", white ? 1 : 3, end);
+            append_movetext(text, line_length, {token, static_cast<std::size_t>(end - token)});
+        }
+
+        auto end = Notation::WriteSAN(token, token + sizeof(token), position, m_moves[i]).ptr;
+        append_movetext(text, line_length, {token, static_cast<std::size_t>(end - token)});
+        position.DoMove(m_moves[i]);
+    }
+    append_movetext(text, line_length, result);
+    text += "\n\n";
+
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
 }
 
-Board Game::GetBoard() const
+bool Game::WritePGN(const char *path, std::span<const PgnTag> tags) const
 {
-    return m_board;
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    if (!file)
+    {
+        Util::Debugger::Debug("[Game::WritePGN] Can't open %s\n", path);
+        return false;
+    }
+
+    WritePGN(file, tags);
+    return file.good();
 }
 
 void Game::Resign()
@@ -86,66 +237,98 @@ void Game::Draw()
     this->m_state = GameState::Draw;
 }
 
+bool Game::DeclineDraw()
+{
+    if (m_state != GameState::Repetition && m_state != GameState::FiftyMoveRule)
+    {
+        return false;
+    }
+
+    m_state = GameState::Waiting;
+    return true;
+}
+
+void Game::GetLegalMoves(MoveList &out) const
+{
+    GenerateLegalMoves(m_position, out);
+}
+
+void Game::GetLegalMoves(const Coordinates &from, MoveList &out) const
+{
+    GenerateLegalMoves(m_position, out, SquareBitboard(from.ToSquare()));
+}
+
 bool Game::MakeMove(Move move)
 {
-    // Considering <Piece>.MakeMove() does not ensure the king is not in check
-    // after the move, the laziest way to do it is to always "simulate" moves
-    // before committing them.
-    auto clone = CloneBoard(m_board);
-    auto piece = clone[move.from.GetRank()][move.from.GetFile()].value();
-    piece->MakeMove(clone, move);
+    // Once over, always over. Evaluating the state again after another move would quietly turn a
+    // declared draw back into an ongoing game
+    if (m_state != GameState::Waiting)
+    {
+        Util::Debugger::Debug("[Game::MakeMove] Game is over\n");
+        return false;
+    }
+
+    // Legal moves are known up front, so there is nothing to try and take back. This also rejects
+    // moving the opponent's pieces or moving from an empty square
+    MoveList legal_moves;
+    GetLegalMoves(move.GetFromCoordinates(), legal_moves);
+    if (std::find(legal_moves.begin(), legal_moves.end(), move) == legal_moves.end())
+    {
+        Util::Debugger::Debug("[Game::MakeMove] Move is not legal\n");
+        return false;
+    }
 
-    // Find our king and make sure it is not in check
-    KingPiece *king = nullptr, *enemy_king = nullptr;
+    m_position.DoMove(move);
+    m_moves.push_back(move);
+    m_hashes.push_back(m_position.GetHash());
+    m_state = _EvaluateState();
 
-    for (auto rank = 0; rank < 8; rank++)
+    return true;
+}
+
+std::optional<Piece> Game::operator[](const Coordinates &coordinates) const
+{
+    return m_position.GetPieceAt(coordinates.ToSquare());
+}
+
+GameState Game::_EvaluateState() const
+{
+    // Nearly every position has a legal move, and the generator stops at the first one.
+    // Checkmate takes precedence over the draw rules below
+    if (HasLegalMove(m_position))
     {
-        for (auto file = 0; file < 8; file++)
+        if (m_position.GetHalfmoveClock() >= 100)
         {
-            auto option = clone[rank][file];
-            if (!option.has_value())
-            {
-                continue;
-            }
-
-            auto piece = option.value();
-            if (piece->GetColor() == m_current_player)
-            {
-                auto found = dynamic_cast<KingPiece *>(piece);
-                if (found != nullptr)
-                {
-                    king = found;
-                    if (found->IsInCheck(clone))
-                    {
-                        Util::Debugger::Debug("[Game::MakeMove] King is in check after move\n");
-                        FreeBoard(clone);
-                        return false;
-                    }
-                }
-            }
-            else
-            {
-                auto found = dynamic_cast<KingPiece *>(piece);
-                if (found != nullptr)
-                {
-                    enemy_king = found;
-                }
-            }
+            return GameState::FiftyMoveRule;
         }
-    }
 
-    FreeBoard(m_board);
-    m_board = clone;
+        if (_IsThreefoldRepetition())
+        {
+            return GameState::Repetition;
+        }
 
-    m_state =
-        king->GetIsMated() || enemy_king->GetIsMated() ? GameState::Ended : GameState::Waiting;
-    m_current_player = m_current_player == Color::White ? Color::Black : Color::White;
+        return GameState::Waiting;
+    }
 
-    return true;
+    return KingPiece::IsInCheck(m_position, GetCurrentPlayer()) ? GameState::Checkmate
+                                                                : GameState::Stalemate;
 }
 
-std::optional<Piece *> Game::operator[](const Coordinates &coordinates)
+bool Game::_IsThreefoldRepetition() const
 {
-    return m_board[coordinates.GetRank()][coordinates.GetFile()];
+    // Positions before the last capture or pawn move can't come up again, and the clock tells how
+    // far back that was. Only positions with the same side to move are worth comparing
+    auto current = m_hashes.size() - 1;
+    auto reversible = std::min<std::size_t>(m_position.GetHalfmoveClock(), current);
+    auto repetitions = 1;
+    for (std::size_t back = 2; back <= reversible; back += 2)
+    {
+        if (m_hashes[current - back] == m_hashes[current] && ++repetitions == 3)
+        {
+            return true;
+        }
+    }
+
+    return false;
 }
 } // namespace Game
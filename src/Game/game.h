@@ -2,7 +2,16 @@
 
 #include "./Piece/piece.h"
 #include "coordinates.h"
+#include "move_list.h"
+#include "position.h"
+#include "position_snapshot.h"
+#include <iosfwd>
+#include <memory>
 #include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace Game
 {
@@ -10,36 +19,92 @@ enum class GameState
 {
     // Waiting for a move
     Waiting,
-    // Game ended normally (clock/checkmate/resignation)
+    // Game ended by resignation
     Ended,
-    // Game ended in a draw (note, stalemate checking does not exist. this is manual)
+    // Game ended in a draw by agreement
     Draw,
+    // The current player is in check and has no legal moves
+    Checkmate,
+    // The current player is not in check, but has no legal moves either
+    Stalemate,
+    // The same position came up for the third time
+    Repetition,
+    // Fifty moves by each side without a capture or pawn move
+    FiftyMoveRule,
+};
+
+// A PGN tag pair, e.g. {"White", "Carlsen"}
+struct PgnTag
+{
+    std::string_view name;
+    std::string_view value;
 };
 
 class Game
 {
   public:
     Game();
+    // Continues from an arbitrary position, which becomes the start of the history. The state is
+    // evaluated right away, so a position that's already mate starts out as ended
+    explicit Game(const Position &position);
+    // Null if the FEN doesn't describe a valid position, see `Position::FromFEN`
+    [[nodiscard]] static std::unique_ptr<Game> FromFEN(std::string_view fen);
     Game(const Game &other) = delete;
     Game &operator=(const Game &other) = delete;
     ~Game();
 
     [[nodiscard]] Color GetCurrentPlayer() const;
     [[nodiscard]] GameState GetState() const;
-    [[nodiscard]] Board GetBoard() const;
+    [[nodiscard]] const Position &GetPosition() const;
+    // Same position as above, but safe to hold on to after further moves are made
+    [[nodiscard]] PositionSnapshot GetSnapshot() const;
+    // Where the game started from. Any later position can be rebuilt by playing `GetMoves()` on it
+    [[nodiscard]] const Position &GetStartingPosition() const;
+    // Every move made so far, from the starting position on
+    [[nodiscard]] const std::vector<Move> &GetMoves() const;
+    // Hash of every position so far, starting position first and the current one last
+    [[nodiscard]] const std::vector<ZobristKey> &GetHashes() const;
+    // Zobrist key of the current position
+    [[nodiscard]] ZobristKey GetHash() const;
+    [[nodiscard]] std::string ToFEN() const;
+    // The game in PGN export format, movetext in SAN. The seven tag roster is always written, with
+    // "?" for whatever `tags` leaves out, then the rest of `tags`. The result comes from the game
+    // state unless a "Result" tag is given, e.g. for a loss on time
+    void WritePGN(std::ostream &out, std::span<const PgnTag> tags = {}) const;
+    // Appends the game to the given file, so many games can be collected in one. False if the file
+    // couldn't be written
+    [[nodiscard]] bool WritePGN(const char *path, std::span<const PgnTag> tags = {}) const;
 
     void Resign();
     void Draw();
+    // Over the board, repetitions and the fifty-move rule only end the game once claimed. This
+    // picks a game ended by either back up, e.g. to replay a recorded game where nobody claimed.
+    // False, and nothing changes, in any other state
+    [[nodiscard]] bool DeclineDraw();
 
-    // Mostly delegates to <Piece>.MakeMove(), but adds some extra checks and maintains
-    // game state.
+    // Every legal move for the current player
+    void GetLegalMoves(MoveList &out) const;
+    // Legal moves of the piece on the given square, if it belongs to the current player
+    void GetLegalMoves(const Coordinates &from, MoveList &out) const;
+
+    // Mostly delegates to Position::DoMove(), but rejects anything `GetLegalMoves` wouldn't
+    // return and maintains game state. Fails once the game is over, draws included.
     [[nodiscard]] bool MakeMove(Move move);
 
-    [[nodiscard]] std::optional<Piece *> operator[](const Coordinates &coordinates);
+    // The piece on the given square, if any
+    [[nodiscard]] std::optional<Piece> operator[](const Coordinates &coordinates) const;
 
   private:
-    Color m_current_player;
     GameState m_state;
-    Board m_board;
+    Position m_position;
+    // Earlier positions aren't kept, the moves and hashes are all that's needed of them
+    Position m_starting_position;
+    std::vector<Move> m_moves;
+    // Hash of every position so far, for repetitions
+    std::vector<ZobristKey> m_hashes;
+
+    // Looks at the position after a move to tell whether the game is over
+    [[nodiscard]] GameState _EvaluateState() const;
+    [[nodiscard]] bool _IsThreefoldRepetition() const;
 };
 } // namespace Game
@@ -1,36 +1,38 @@
 #include "move.h"
+#include "move_list.h"
+#include "notation.h"
 
 namespace Game
 {
-std::vector<Move> Move::GetPromotionMoves(Coordinates from, Coordinates to)
+void Move::GetPromotionMoves(Square from, Square to, MoveList &out)
 {
-    std::vector<Move> out;
-
-    out.push_back(Move(from, to, PromotionKind::Knight));
-    out.push_back(Move(from, to, PromotionKind::Bishop));
-    out.push_back(Move(from, to, PromotionKind::Rook));
-    out.push_back(Move(from, to, PromotionKind::Queen));
-
-    return out;
+    out.Push(Move(from, to, PromotionKind::Knight));
+    out.Push(Move(from, to, PromotionKind::Bishop));
+    out.Push(Move(from, to, PromotionKind::Rook));
+    out.Push(Move(from, to, PromotionKind::Queen));
 }
 
-Move::Move(Coordinates from, Coordinates to) : from(from), to(to)
+Move::Move(Coordinates from, Coordinates to) : Move(from.ToSquare(), to.ToSquare())
 {
 }
-Move::Move(Coordinates from, Coordinates to, Coordinates passanted)
-    : from(from), to(to), passanted(passanted)
+Move::Move(Coordinates from, Coordinates to, PromotionKind kind)
+    : Move(from.ToSquare(), to.ToSquare(), kind)
 {
 }
-Move::Move(Coordinates from, Coordinates to, PromotionKind promotionKind)
-    : from(from), to(to), promotionKind(promotionKind)
+
+std::string Move::ToString() const
 {
+    char buffer[Notation::MaxUCILength];
+    auto end = Notation::WriteUCI(buffer, buffer + sizeof(buffer), *this).ptr;
+    return std::string(buffer, end);
 }
-Move::Move(Coordinates from, Coordinates to, CastleKind castleKind)
-    : from(from), to(to), castleKind(castleKind)
+
+Coordinates Move::GetFromCoordinates() const
 {
+    return Coordinates::FromSquare(GetFrom());
 }
-Move::Move(Coordinates from, Coordinates to, PromotionKind promotionKind, CastleKind castleKind)
-    : from(from), to(to), promotionKind(promotionKind), castleKind(castleKind)
+Coordinates Move::GetToCoordinates() const
 {
+    return Coordinates::FromSquare(GetTo());
 }
 } // namespace Game
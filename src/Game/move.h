@@ -1,12 +1,15 @@
 #pragma once
 
 #include "coordinates.h"
-#include <optional>
-#include <vector>
+#include <cstdint>
+#include <string>
 
 namespace Game
 {
-enum class PromotionKind
+class MoveList;
+
+// The underlying values are part of the `Move` encoding
+enum class PromotionKind : std::uint8_t
 {
     Knight,
     Bishop,
@@ -20,21 +23,117 @@ enum class CastleKind
     Short
 };
 
-struct Move
+enum class MoveFlag : std::uint8_t
+{
+    Normal,
+    Promotion,
+    EnPassant,
+    // Encoded as the king's move, the rook follows implicitly
+    Castle,
+};
+
+// A move packed into 16 bits:
+// bits 0-5 hold the origin square, 6-11 the destination, 12-13 the promotion kind and 14-15 the
+// `MoveFlag`. Small enough to be stored by the hundreds in move lists, history tables and
+// transposition entries.
+class Move
 {
-    [[nodiscard]] static std::vector<Move> GetPromotionMoves(Coordinates from, Coordinates to);
+  public:
+    // A "null" move (A1 to A1). Never generated, but handy as an empty value
+    constexpr Move() = default;
+
+    constexpr Move(Square from, Square to, MoveFlag flag = MoveFlag::Normal)
+        : m_data(static_cast<std::uint16_t>(from | (to << 6) | (static_cast<int>(flag) << 14)))
+    {
+    }
+
+    constexpr Move(Square from, Square to, PromotionKind kind)
+        : m_data(static_cast<std::uint16_t>(
+              from | (to << 6) | (static_cast<int>(kind) << 12) |
+              (static_cast<int>(MoveFlag::Promotion) << 14)
+          ))
+    {
+    }
 
+    // Conversion helpers for the GUI, which works with `Coordinates`
     Move(Coordinates from, Coordinates to);
-    Move(Coordinates from, Coordinates to, Coordinates passanted);
-    Move(Coordinates from, Coordinates to, PromotionKind);
-    Move(Coordinates from, Coordinates to, CastleKind);
-    Move(Coordinates from, Coordinates to, PromotionKind, CastleKind);
+    Move(Coordinates from, Coordinates to, PromotionKind kind);
+
+    // Appends one move per promotion kind
+    static void GetPromotionMoves(Square from, Square to, MoveList &out);
+
+    // Long algebraic notation as used by UCI, e.g. "e2e4" or "e7e8q". See `Notation::WriteUCI`
+    // for the allocation-free version
+    [[nodiscard]] std::string ToString() const;
+
+    [[nodiscard]] static constexpr Move FromRaw(std::uint16_t raw)
+    {
+        Move move;
+        move.m_data = raw;
+        return move;
+    }
+
+    [[nodiscard]] constexpr std::uint16_t GetRaw() const
+    {
+        return m_data;
+    }
+
+    [[nodiscard]] constexpr Square GetFrom() const
+    {
+        return m_data & 0x3F;
+    }
 
-    Coordinates from;
-    Coordinates to;
+    [[nodiscard]] constexpr Square GetTo() const
+    {
+        return (m_data >> 6) & 0x3F;
+    }
 
-    std::optional<Coordinates> passanted;
-    std::optional<PromotionKind> promotionKind;
-    std::optional<CastleKind> castleKind;
+    [[nodiscard]] constexpr MoveFlag GetFlag() const
+    {
+        return static_cast<MoveFlag>(m_data >> 14);
+    }
+
+    [[nodiscard]] constexpr bool IsPromotion() const
+    {
+        return GetFlag() == MoveFlag::Promotion;
+    }
+
+    // Only meaningful for promotions
+    [[nodiscard]] constexpr PromotionKind GetPromotionKind() const
+    {
+        return static_cast<PromotionKind>((m_data >> 12) & 0x3);
+    }
+
+    [[nodiscard]] constexpr bool IsEnPassant() const
+    {
+        return GetFlag() == MoveFlag::EnPassant;
+    }
+
+    // Square of the pawn captured en passant: the rank we leave from, the file we arrive on
+    [[nodiscard]] constexpr Square GetPassantedSquare() const
+    {
+        return MakeSquare(RankOf(GetFrom()), FileOf(GetTo()));
+    }
+
+    [[nodiscard]] constexpr bool IsCastle() const
+    {
+        return GetFlag() == MoveFlag::Castle;
+    }
+
+    // Only meaningful for castling moves
+    [[nodiscard]] constexpr CastleKind GetCastleKind() const
+    {
+        return FileOf(GetTo()) > FileOf(GetFrom()) ? CastleKind::Short : CastleKind::Long;
+    }
+
+    [[nodiscard]] Coordinates GetFromCoordinates() const;
+    [[nodiscard]] Coordinates GetToCoordinates() const;
+
+    constexpr bool operator==(const Move &other) const = default;
+
+  private:
+    std::uint16_t m_data = 0;
 };
+
+static_assert(sizeof(Move) == 2);
 } // namespace Game
@@ -0,0 +1,252 @@
+#include "move_generator.h"
+
+namespace Game
+{
+// Where generated moves go. `Add` returns true to stop generating, which lets `HasLegalMove` bail
+// out on the first legal move it sees
+struct ListSink
+{
+    MoveList &out;
+
+    bool Add(Move move)
+    {
+        out.Push(move);
+        return false;
+    }
+};
+
+struct AnySink
+{
+    bool Add(Move)
+    {
+        return true;
+    }
+};
+
+template <typename Sink> static bool add_pawn_move(Sink &sink, Square from, Square to)
+{
+    if (!(SquareBitboard(to) & (Rank1Bitboard | Rank8Bitboard)))
+    {
+        return sink.Add(Move(from, to));
+    }
+
+    // Same order as `Move::GetPromotionMoves`
+    for (auto kind :
+         {PromotionKind::Knight, PromotionKind::Bishop, PromotionKind::Rook, PromotionKind::Queen})
+    {
+        if (sink.Add(Move(from, to, kind)))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Castling is never allowed out of, through or into check. The king's path is checked here, the
+// destination along with it
+template <typename Sink>
+static bool generate_castling(const Position &position, Square king, Sink &sink)
+{
+    auto us = position.GetSideToMove();
+    auto them = OppositeColor(us);
+    auto rank = RankOf(king);
+    auto occupancy = position.GetOccupancy();
+    auto rooks = position.GetPieces(us, PieceType::Rook);
+
+    for (auto kind : {CastleKind::Short, CastleKind::Long})
+    {
+        if (!position.HasCastlingRight(us, kind))
+        {
+            continue;
+        }
+
+        auto rook = MakeSquare(rank, kind == CastleKind::Short ? 7 : 0);
+        auto to = MakeSquare(rank, kind == CastleKind::Short ? 6 : 2);
+        // Positions can be set up with the right but without the rook
+        if (!(rooks & SquareBitboard(rook)) || (BetweenBitboard(king, rook) & occupancy))
+        {
+            continue;
+        }
+
+        auto path = BetweenBitboard(king, to) | SquareBitboard(to);
+        auto safe = true;
+        while (path && safe)
+        {
+            safe = !position.IsSquareAttacked(PopLsb(path), them, occupancy);
+        }
+
+        if (safe && sink.Add(Move(king, to, MoveFlag::Castle)))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Returns true if the sink asked to stop
+template <typename Sink>
+static bool generate(const Position &position, Sink &sink, Bitboard from)
+{
+    auto us = position.GetSideToMove();
+    auto them = OppositeColor(us);
+    auto own = position.GetPieces(us);
+    auto enemies = position.GetPieces(them);
+    auto occupancy = position.GetOccupancy();
+    auto king = position.GetKingSquare(us);
+
+    auto checkers = position.GetAttackersTo(king, occupancy) & enemies;
+
+    // King moves, checked with the king lifted off the board so it can't step back along a
+    // slider's ray
+    if (from & SquareBitboard(king))
+    {
+        auto without_king = occupancy & ~SquareBitboard(king);
+        auto targets = KingAttacks(king) & ~own;
+        while (targets)
+        {
+            auto to = PopLsb(targets);
+            if (!position.IsSquareAttacked(to, them, without_king) && sink.Add(Move(king, to)))
+            {
+                return true;
+            }
+        }
+
+        if (!checkers && generate_castling(position, king, sink))
+        {
+            return true;
+        }
+    }
+
+    // In double check, only the king can move
+    if (PopCount(checkers) > 1)
+    {
+        return false;
+    }
+
+    // When in check, other pieces must capture the checker or block between it and the king
+    auto check_mask = checkers ? checkers | BetweenBitboard(king, Lsb(checkers)) : AllSquares;
+
+    // Pieces that can't leave the line between an enemy slider and our king. Snipers are found by
+    // looking out from the king through everything but our own pieces
+    Bitboard pinned = 0;
+    auto snipers =
+        (RookAttacks(king, enemies) & (position.GetPieces(them, PieceType::Rook) |
+                                       position.GetPieces(them, PieceType::Queen))) |
+        (BishopAttacks(king, enemies) & (position.GetPieces(them, PieceType::Bishop) |
+                                         position.GetPieces(them, PieceType::Queen)));
+    while (snipers)
+    {
+        auto blockers = BetweenBitboard(king, PopLsb(snipers)) & occupancy;
+        if (PopCount(blockers) == 1)
+        {
+            pinned |= blockers & own;
+        }
+    }
+
+    auto pieces = own & from & ~SquareBitboard(king);
+    while (pieces)
+    {
+        auto square = PopLsb(pieces);
+        auto allowed = check_mask;
+        if (pinned & SquareBitboard(square))
+        {
+            allowed &= LineBitboard(king, square);
+        }
+
+        auto type = position.GetPieceAt(square)->GetType();
+        if (type != PieceType::Pawn)
+        {
+            Bitboard attacks = 0;
+            switch (type)
+            {
+                case PieceType::Knight:
+                    attacks = KnightAttacks(square);
+                    break;
+                case PieceType::Bishop:
+                    attacks = BishopAttacks(square, occupancy);
+                    break;
+                case PieceType::Rook:
+                    attacks = RookAttacks(square, occupancy);
+                    break;
+                case PieceType::Queen:
+                    attacks = QueenAttacks(square, occupancy);
+                    break;
+                default:
+                    break;
+            }
+
+            auto targets = attacks & ~own & allowed;
+            while (targets)
+            {
+                if (sink.Add(Move(square, PopLsb(targets))))
+                {
+                    return true;
+                }
+            }
+
+            continue;
+        }
+
+        // Pawns. For all intents and purposes, "up" can mean down for black
+        auto up = us == Color::White ? 8 : -8;
+        auto start_rank = us == Color::White ? 1 : 6;
+
+        Square one_up = square + up;
+        if (!(occupancy & SquareBitboard(one_up)))
+        {
+            if ((allowed & SquareBitboard(one_up)) && add_pawn_move(sink, square, one_up))
+            {
+                return true;
+            }
+
+            Square two_up = one_up + up;
+            if (RankOf(square) == start_rank && !(occupancy & SquareBitboard(two_up)) &&
+                (allowed & SquareBitboard(two_up)) && sink.Add(Move(square, two_up)))
+            {
+                return true;
+            }
+        }
+
+        auto captures = PawnAttacks(us, square) & enemies & allowed;
+        while (captures)
+        {
+            if (add_pawn_move(sink, square, PopLsb(captures)))
+            {
+                return true;
+            }
+        }
+
+        // En passant removes two pieces from the capturing pawn's rank at once, which can expose
+        // the king sideways in ways pins don't cover. It's rare enough to just check the
+        // resulting occupancy directly
+        auto en_passant = position.GetEnPassantSquare();
+        if (en_passant != NoSquare && (PawnAttacks(us, square) & SquareBitboard(en_passant)))
+        {
+            auto move = Move(square, en_passant, MoveFlag::EnPassant);
+            auto captured = SquareBitboard(move.GetPassantedSquare());
+            auto after = (occupancy ^ SquareBitboard(square) ^ captured) |
+                         SquareBitboard(en_passant);
+            if (!(position.GetAttackersTo(king, after) & enemies & ~captured) && sink.Add(move))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void GenerateLegalMoves(const Position &position, MoveList &out, Bitboard from)
+{
+    auto sink = ListSink{out};
+    generate(position, sink, from);
+}
+
+bool HasLegalMove(const Position &position)
+{
+    auto sink = AnySink{};
+    return generate(position, sink, AllSquares);
+}
+} // namespace Game
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "bitboard.h"
+#include "move_list.h"
+#include "position.h"
+
+namespace Game
+{
+constexpr Bitboard AllSquares = ~Bitboard(0);
+
+// Appends every legal move for the side to move. Unlike `Piece::GetPossibleMoves`, checks and pins
+// are worked out once up front, so nothing has to be tried on the board and taken back.
+// Only pieces standing on `from` are considered.
+void GenerateLegalMoves(const Position &position, MoveList &out, Bitboard from = AllSquares);
+
+// Whether the side to move has any legal move at all. Stops at the first one it finds, so it's
+// usually much cheaper than generating the full list
+[[nodiscard]] bool HasLegalMove(const Position &position);
+} // namespace Game
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "move.h"
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+namespace Game
+{
+// Fixed-capacity list of moves living entirely on the stack. Move generators append to one of
+// these instead of returning fresh vectors, so generating moves never touches the heap.
+class MoveList
+{
+  public:
+    // No reachable chess position has more than 218 moves
+    static constexpr std::size_t s_capacity = 256;
+
+    void Push(Move move)
+    {
+        assert(m_size < s_capacity);
+        m_moves[m_size++] = move;
+    }
+
+    void Clear()
+    {
+        m_size = 0;
+    }
+
+    [[nodiscard]] std::size_t GetSize() const
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] bool IsEmpty() const
+    {
+        return m_size == 0;
+    }
+
+    [[nodiscard]] const Move &operator[](std::size_t index) const
+    {
+        assert(index < m_size);
+        return m_moves[index];
+    }
+
+    // Lets move ordering rearrange the list in place
+    [[nodiscard]] Move &operator[](std::size_t index)
+    {
+        assert(index < m_size);
+        return m_moves[index];
+    }
+
+    [[nodiscard]] const Move *begin() const
+    {
+        return m_moves.data();
+    }
+
+    [[nodiscard]] const Move *end() const
+    {
+        return m_moves.data() + m_size;
+    }
+
+  private:
+    std::array<Move, s_capacity> m_moves;
+    std::size_t m_size = 0;
+};
+} // namespace Game
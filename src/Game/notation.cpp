@@ -0,0 +1,538 @@
+#include "notation.h"
+#include "bitboard.h"
+#include "move_generator.h"
+
+namespace Game
+{
+// Fills a caller's buffer, remembering whether anything didn't fit
+class BufferWriter
+{
+  public:
+    BufferWriter(char *first, char *last) : m_current(first), m_last(last), m_overflow(false)
+    {
+    }
+
+    void Put(char c)
+    {
+        if (m_current == m_last)
+        {
+            m_overflow = true;
+            return;
+        }
+
+        *m_current++ = c;
+    }
+
+    void Put(std::string_view text)
+    {
+        for (auto c : text)
+        {
+            Put(c);
+        }
+    }
+
+    void PutSquare(Square square)
+    {
+        Put(static_cast<char>('a' + FileOf(square)));
+        Put(static_cast<char>('1' + RankOf(square)));
+    }
+
+    void PutNumber(unsigned value)
+    {
+        auto [end, error] = std::to_chars(m_current, m_last, value);
+        if (error != std::errc())
+        {
+            m_overflow = true;
+            return;
+        }
+
+        m_current = end;
+    }
+
+    [[nodiscard]] std::to_chars_result Finish() const
+    {
+        if (m_overflow)
+        {
+            return {m_last, std::errc::value_too_large};
+        }
+
+        return {m_current, std::errc()};
+    }
+
+  private:
+    char *m_current;
+    char *m_last;
+    bool m_overflow;
+};
+
+std::to_chars_result Notation::WriteSquare(char *first, char *last, Square square)
+{
+    BufferWriter writer(first, last);
+    writer.PutSquare(square);
+    return writer.Finish();
+}
+
+std::optional<Square> Notation::ParseSquare(std::string_view text)
+{
+    if (text.size() != 2 || text[0] < 'a' || text[0] > 'h' || text[1] < '1' || text[1] > '8')
+    {
+        return std::nullopt;
+    }
+
+    return MakeSquare(text[1] - '1', text[0] - 'a');
+}
+
+std::to_chars_result Notation::WriteUCI(char *first, char *last, Move move)
+{
+    static constexpr char promotion_names[] = "nbrq";
+
+    BufferWriter writer(first, last);
+    writer.PutSquare(move.GetFrom());
+    writer.PutSquare(move.GetTo());
+    if (move.IsPromotion())
+    {
+        writer.Put(promotion_names[static_cast<int>(move.GetPromotionKind())]);
+    }
+
+    return writer.Finish();
+}
+
+std::optional<Move> Notation::ParseUCI(const Position &position, std::string_view text)
+{
+    if (text.size() != 4 && text.size() != 5)
+    {
+        return std::nullopt;
+    }
+
+    auto from = ParseSquare(text.substr(0, 2));
+    auto to = ParseSquare(text.substr(2, 2));
+    if (!from.has_value() || !to.has_value())
+    {
+        return std::nullopt;
+    }
+
+    std::optional<PromotionKind> promotion;
+    if (text.size() == 5)
+    {
+        switch (text[4])
+        {
+            case 'n':
+                promotion = PromotionKind::Knight;
+                break;
+            case 'b':
+                promotion = PromotionKind::Bishop;
+                break;
+            case 'r':
+                promotion = PromotionKind::Rook;
+                break;
+            case 'q':
+                promotion = PromotionKind::Queen;
+                break;
+            default:
+                return std::nullopt;
+        }
+    }
+
+    MoveList moves;
+    GenerateLegalMoves(position, moves, SquareBitboard(from.value()));
+    for (auto move : moves)
+    {
+        if (move.GetTo() != to.value() || move.IsPromotion() != promotion.has_value())
+        {
+            continue;
+        }
+
+        if (!promotion.has_value() || move.GetPromotionKind() == promotion.value())
+        {
+            return move;
+        }
+    }
+
+    return std::nullopt;
+}
+
+[[nodiscard]] static std::optional<PieceType> piece_from_san(char c)
+{
+    switch (c)
+    {
+        case 'N':
+            return PieceType::Knight;
+        case 'B':
+            return PieceType::Bishop;
+        case 'R':
+            return PieceType::Rook;
+        case 'Q':
+            return PieceType::Queen;
+        case 'K':
+            return PieceType::King;
+        default:
+            return std::nullopt;
+    }
+}
+
+[[nodiscard]] static std::optional<PromotionKind> promotion_from_san(char c)
+{
+    switch (c)
+    {
+        case 'N':
+            return PromotionKind::Knight;
+        case 'B':
+            return PromotionKind::Bishop;
+        case 'R':
+            return PromotionKind::Rook;
+        case 'Q':
+            return PromotionKind::Queen;
+        default:
+            return std::nullopt;
+    }
+}
+
+[[nodiscard]] static std::optional<Move> parse_castle(const Position &position, CastleKind kind)
+{
+    auto king = position.GetKingSquare(position.GetSideToMove());
+
+    MoveList moves;
+    GenerateLegalMoves(position, moves, SquareBitboard(king));
+    for (auto move : moves)
+    {
+        if (move.IsCastle() && move.GetCastleKind() == kind)
+        {
+            return move;
+        }
+    }
+
+    return std::nullopt;
+}
+
+// Whether the piece on `from` may go to `to` without leaving its own king in check. Moving the same
+// kind of piece to the same square resolves the same checks, so this only has to look for pins
+[[nodiscard]] static bool can_move_without_exposing_king(
+    const Position &position, Square from, Square to
+)
+{
+    auto us = position.GetSideToMove();
+    auto occupancy = (position.GetOccupancy() & ~SquareBitboard(from)) | SquareBitboard(to);
+    auto attackers = position.GetAttackersTo(position.GetKingSquare(us), occupancy) &
+                     position.GetPieces(OppositeColor(us)) & ~SquareBitboard(to);
+    return attackers == 0;
+}
+
+// Whether the move attacks the enemy king, either with the moved piece (or the castling rook) or
+// by uncovering one of our sliders
+[[nodiscard]] static bool gives_check(const Position &position, Move move)
+{
+    auto us = position.GetSideToMove();
+    auto king = position.GetKingSquare(OppositeColor(us));
+    auto from = move.GetFrom();
+    auto to = move.GetTo();
+    auto type = move.IsPromotion() ? PromotedPieceType(move.GetPromotionKind())
+                                   : position.GetPieceAt(from)->GetType();
+
+    auto occupancy = (position.GetOccupancy() & ~SquareBitboard(from)) | SquareBitboard(to);
+    auto moved = SquareBitboard(from);
+    if (move.IsEnPassant())
+    {
+        occupancy &= ~SquareBitboard(move.GetPassantedSquare());
+    }
+
+    if (move.IsCastle())
+    {
+        auto [rook_from, rook_to] = CastlingRookSquares(move);
+        occupancy = (occupancy & ~SquareBitboard(rook_from)) | SquareBitboard(rook_to);
+        moved |= SquareBitboard(rook_from);
+        if (RookAttacks(rook_to, occupancy) & SquareBitboard(king))
+        {
+            return true;
+        }
+    }
+
+    Bitboard attacks = 0;
+    switch (type)
+    {
+        case PieceType::Pawn:
+            attacks = PawnAttacks(us, to);
+            break;
+        case PieceType::Knight:
+            attacks = KnightAttacks(to);
+            break;
+        case PieceType::Bishop:
+            attacks = BishopAttacks(to, occupancy);
+            break;
+        case PieceType::Rook:
+            attacks = RookAttacks(to, occupancy);
+            break;
+        case PieceType::Queen:
+            attacks = QueenAttacks(to, occupancy);
+            break;
+        case PieceType::King:
+            break;
+    }
+
+    if (attacks & SquareBitboard(king))
+    {
+        return true;
+    }
+
+    auto queens = position.GetPieces(us, PieceType::Queen);
+    auto diagonal = position.GetPieces(us, PieceType::Bishop) | queens;
+    auto straight = position.GetPieces(us, PieceType::Rook) | queens;
+    auto discovered = (BishopAttacks(king, occupancy) & diagonal) |
+                      (RookAttacks(king, occupancy) & straight);
+    return (discovered & ~moved) != 0;
+}
+
+std::optional<Move> Notation::ParseSAN(const Position &position, std::string_view san)
+{
+    while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' ||
+                            san.back() == '?'))
+    {
+        san.remove_suffix(1);
+    }
+
+    if (san == "O-O" || san == "0-0")
+    {
+        return parse_castle(position, CastleKind::Short);
+    }
+
+    if (san == "O-O-O" || san == "0-0-0")
+    {
+        return parse_castle(position, CastleKind::Long);
+    }
+
+    auto type = PieceType::Pawn;
+    if (!san.empty())
+    {
+        if (auto piece = piece_from_san(san.front()); piece.has_value())
+        {
+            type = piece.value();
+            san.remove_prefix(1);
+        }
+    }
+
+    std::optional<PromotionKind> promotion;
+    if (type == PieceType::Pawn && !san.empty())
+    {
+        promotion = promotion_from_san(san.back());
+        if (promotion.has_value())
+        {
+            san.remove_suffix(san.size() >= 2 && san[san.size() - 2] == '=' ? 2 : 1);
+        }
+    }
+
+    if (san.size() < 2)
+    {
+        return std::nullopt;
+    }
+
+    auto to_file = san[san.size() - 2] - 'a';
+    auto to_rank = san[san.size() - 1] - '1';
+    if (to_file < 0 || to_file > 7 || to_rank < 0 || to_rank > 7)
+    {
+        return std::nullopt;
+    }
+    san.remove_suffix(2);
+
+    // Whatever is left in between narrows down where the piece comes from
+    auto from = position.GetPieces(position.GetSideToMove(), type);
+    for (auto c : san)
+    {
+        if (c >= 'a' && c <= 'h')
+        {
+            from &= FileABitboard << (c - 'a');
+        }
+        else if (c >= '1' && c <= '8')
+        {
+            from &= Rank1Bitboard << (8 * (c - '1'));
+        }
+        else if (c != 'x' && c != ':' && c != '-')
+        {
+            return std::nullopt;
+        }
+    }
+
+    auto to = MakeSquare(to_rank, to_file);
+
+    MoveList moves;
+    GenerateLegalMoves(position, moves, from);
+
+    std::optional<Move> found;
+    for (auto move : moves)
+    {
+        if (move.GetTo() != to || move.IsCastle() || move.IsPromotion() != promotion.has_value())
+        {
+            continue;
+        }
+
+        if (promotion.has_value() && move.GetPromotionKind() != promotion.value())
+        {
+            continue;
+        }
+
+        // Two candidates means the disambiguation was missing
+        if (found.has_value())
+        {
+            return std::nullopt;
+        }
+        found = move;
+    }
+
+    return found;
+}
+
+std::to_chars_result Notation::WriteSAN(
+    char *first, char *last, const Position &position, Move move
+)
+{
+    static constexpr char piece_letters[] = "PNBRQK";
+    static constexpr char promotion_letters[] = "NBRQ";
+
+    auto from = move.GetFrom();
+    auto to = move.GetTo();
+    auto type = position.GetPieceAt(from)->GetType();
+    auto capture = move.IsEnPassant() || position.GetPieceAt(to).has_value();
+
+    BufferWriter writer(first, last);
+    if (move.IsCastle())
+    {
+        writer.Put(move.GetCastleKind() == CastleKind::Short ? "O-O" : "O-O-O");
+    }
+    else if (type == PieceType::Pawn)
+    {
+        if (capture)
+        {
+            writer.Put(static_cast<char>('a' + FileOf(from)));
+            writer.Put('x');
+        }
+        writer.PutSquare(to);
+        if (move.IsPromotion())
+        {
+            writer.Put('=');
+            writer.Put(promotion_letters[static_cast<int>(move.GetPromotionKind())]);
+        }
+    }
+    else
+    {
+        writer.Put(piece_letters[static_cast<int>(type)]);
+
+        // Other pieces of the same kind that could go to the same square. There's only one king
+        Bitboard others = 0;
+        if (type != PieceType::King)
+        {
+            auto candidates = position.GetAttackersTo(to, position.GetOccupancy()) &
+                              position.GetPieces(position.GetSideToMove(), type) &
+                              ~SquareBitboard(from);
+            while (candidates)
+            {
+                auto square = PopLsb(candidates);
+                if (can_move_without_exposing_king(position, square, to))
+                {
+                    others |= SquareBitboard(square);
+                }
+            }
+        }
+
+        if (others)
+        {
+            auto same_file = (others & (FileABitboard << FileOf(from))) != 0;
+            auto same_rank = (others & (Rank1Bitboard << (8 * RankOf(from)))) != 0;
+            if (!same_file || same_rank)
+            {
+                writer.Put(static_cast<char>('a' + FileOf(from)));
+            }
+            if (same_file)
+            {
+                writer.Put(static_cast<char>('1' + RankOf(from)));
+            }
+        }
+
+        if (capture)
+        {
+            writer.Put('x');
+        }
+        writer.PutSquare(to);
+    }
+
+    // Copying the position is a memcpy, and it only happens for the few moves that give check
+    if (gives_check(position, move))
+    {
+        auto after = position;
+        after.DoMove(move);
+        writer.Put(HasLegalMove(after) ? '+' : '#');
+    }
+
+    return writer.Finish();
+}
+
+std::to_chars_result Notation::WriteFEN(char *first, char *last, const Position &position)
+{
+    static constexpr char names[2][PieceTypeCount + 1] = {"PNBRQK", "pnbrqk"};
+
+    BufferWriter writer(first, last);
+    for (auto rank = 7; rank >= 0; rank--)
+    {
+        auto empty = 0;
+        for (auto file = 0; file < 8; file++)
+        {
+            auto piece = position.GetPieceAt(MakeSquare(rank, file));
+            if (!piece.has_value())
+            {
+                empty++;
+                continue;
+            }
+
+            if (empty > 0)
+            {
+                writer.Put(static_cast<char>('0' + empty));
+                empty = 0;
+            }
+            auto color = static_cast<int>(piece->GetColor());
+            writer.Put(names[color][static_cast<int>(piece->GetType())]);
+        }
+
+        if (empty > 0)
+        {
+            writer.Put(static_cast<char>('0' + empty));
+        }
+        if (rank > 0)
+        {
+            writer.Put('/');
+        }
+    }
+
+    writer.Put(position.GetSideToMove() == Color::White ? " w " : " b ");
+
+    auto castling_rights = position.GetCastlingRights();
+    if (castling_rights == CastlingRights::None)
+    {
+        writer.Put('-');
+    }
+    else
+    {
+        static constexpr char rights[] = "KQkq";
+        for (auto i = 0; i < 4; i++)
+        {
+            if (castling_rights & (1 << i))
+            {
+                writer.Put(rights[i]);
+            }
+        }
+    }
+
+    writer.Put(' ');
+    if (position.GetEnPassantSquare() == NoSquare)
+    {
+        writer.Put('-');
+    }
+    else
+    {
+        writer.PutSquare(position.GetEnPassantSquare());
+    }
+
+    writer.Put(' ');
+    writer.PutNumber(static_cast<unsigned>(position.GetHalfmoveClock()));
+    writer.Put(' ');
+    writer.PutNumber(static_cast<unsigned>(position.GetFullmoveNumber()));
+
+    return writer.Finish();
+}
+} // namespace Game
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "coordinates.h"
+#include "move.h"
+#include "position.h"
+#include <charconv>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+namespace Game
+{
+// Text formats for squares, moves and positions, without touching the heap.
+//
+// Writers work like `std::to_chars`: they fill [first, last) and return one past the last
+// character written. If the text doesn't fit, they return `last` with `value_too_large` and the
+// buffer contents are unspecified. Nothing is null terminated. A buffer of the matching `Max...`
+// length always fits.
+//
+// Parsers return nothing for malformed or illegal input, they never throw.
+namespace Notation
+{
+constexpr std::size_t MaxSquareLength = 2;
+// e.g. "e7e8q"
+constexpr std::size_t MaxUCILength = 5;
+// e.g. "exd8=Q#" or "Qh4xe1+"
+constexpr std::size_t MaxSANLength = 7;
+// 64 pieces and 7 slashes, side, castling, en passant, two five digit clocks and 5 spaces
+constexpr std::size_t MaxFENLength = 71 + 1 + 4 + 2 + 5 + 5 + 5;
+
+// Lowercase file then rank, e.g. "e4"
+std::to_chars_result WriteSquare(char *first, char *last, Square square);
+[[nodiscard]] std::optional<Square> ParseSquare(std::string_view text);
+
+// Long algebraic notation as used by UCI, e.g. "e2e4", "e7e8q" or "e1g1" for castling
+std::to_chars_result WriteUCI(char *first, char *last, Move move);
+// Matched against the legal moves, which fills in the flags the notation leaves implicit
+[[nodiscard]] std::optional<Move> ParseUCI(const Position &position, std::string_view text);
+
+// Standard Algebraic Notation of a legal move, including the "+" or "#" suffix. Disambiguation
+// and checks are worked out from attack bitboards. Only checks need a look past the move, to tell
+// whether the reply is forced mate
+std::to_chars_result WriteSAN(char *first, char *last, const Position &position, Move move);
+// Resolves SAN ("Nbd7", "exd6", "e8=Q+", "O-O") against the legal moves of the side to move.
+// Check and annotation suffixes are ignored, and so are the common deviations of "0-0" for
+// castling and a promotion piece without the "=". Returns nothing if the move is malformed,
+// illegal or ambiguous
+[[nodiscard]] std::optional<Move> ParseSAN(const Position &position, std::string_view san);
+
+// All six fields, always. The parsing counterpart is `Position::FromFEN`
+std::to_chars_result WriteFEN(char *first, char *last, const Position &position);
+} // namespace Notation
+} // namespace Game
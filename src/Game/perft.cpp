@@ -0,0 +1,214 @@
+#include "perft.h"
+#include "move_generator.h"
+#include "move_list.h"
+#include <algorithm>
+#include <bit>
+#include <thread>
+
+namespace Game
+{
+PerftTable::PerftTable(std::size_t size_mb) : m_entries(nullptr), m_mask(0)
+{
+    auto count = std::bit_floor(std::max<std::size_t>(size_mb * 1024 * 1024 / sizeof(Entry), 1));
+    m_entries = std::make_unique<Entry[]>(count);
+    m_mask = count - 1;
+}
+
+std::optional<std::uint64_t> PerftTable::Probe(ZobristKey key, int depth) const
+{
+    const auto &entry = m_entries[key & m_mask];
+    auto data = entry.data.load(std::memory_order_relaxed);
+    auto check = entry.check.load(std::memory_order_relaxed);
+    if ((check ^ data) != key || static_cast<int>(data & 0xFF) != depth)
+    {
+        return std::nullopt;
+    }
+
+    return data >> 8;
+}
+
+void PerftTable::Store(ZobristKey key, int depth, std::uint64_t nodes)
+{
+    auto &entry = m_entries[key & m_mask];
+    auto data = (nodes << 8) | static_cast<std::uint64_t>(depth & 0xFF);
+    entry.check.store(key ^ data, std::memory_order_relaxed);
+    entry.data.store(data, std::memory_order_relaxed);
+}
+
+std::uint64_t Perft(Position &position, int depth, PerftTable *table)
+{
+    if (depth <= 0)
+    {
+        return 1;
+    }
+
+    MoveList moves;
+    GenerateLegalMoves(position, moves);
+    // Every legal move is a leaf one ply from the bottom, no need to play them out
+    if (depth == 1)
+    {
+        return moves.GetSize();
+    }
+
+    if (table != nullptr)
+    {
+        auto cached = table->Probe(position.GetHash(), depth);
+        if (cached.has_value())
+        {
+            return cached.value();
+        }
+    }
+
+    std::uint64_t nodes = 0;
+    for (auto move : moves)
+    {
+        auto undo = position.DoMove(move);
+        nodes += Perft(position, depth - 1, table);
+        position.UndoMove(move, undo);
+    }
+
+    if (table != nullptr)
+    {
+        table->Store(position.GetHash(), depth, nodes);
+    }
+
+    return nodes;
+}
+
+std::optional<std::uint64_t> Perft(
+    Position &position, int depth, std::chrono::steady_clock::time_point deadline, PerftTable *table
+)
+{
+    // Close to the leaves there is too little work to be worth looking at the clock
+    if (depth <= 3)
+    {
+        return Perft(position, depth, table);
+    }
+
+    if (std::chrono::steady_clock::now() >= deadline)
+    {
+        return std::nullopt;
+    }
+
+    if (table != nullptr)
+    {
+        auto cached = table->Probe(position.GetHash(), depth);
+        if (cached.has_value())
+        {
+            return cached.value();
+        }
+    }
+
+    MoveList moves;
+    GenerateLegalMoves(position, moves);
+
+    std::uint64_t nodes = 0;
+    for (auto move : moves)
+    {
+        auto undo = position.DoMove(move);
+        auto subtree = Perft(position, depth - 1, deadline, table);
+        position.UndoMove(move, undo);
+
+        if (!subtree.has_value())
+        {
+            return std::nullopt;
+        }
+        nodes += subtree.value();
+    }
+
+    if (table != nullptr)
+    {
+        table->Store(position.GetHash(), depth, nodes);
+    }
+
+    return nodes;
+}
+
+std::vector<PerftDivision> PerftDivide(Position &position, int depth, PerftTable *table)
+{
+    std::vector<PerftDivision> out;
+    if (depth <= 0)
+    {
+        return out;
+    }
+
+    MoveList moves;
+    GenerateLegalMoves(position, moves);
+    out.reserve(moves.GetSize());
+    for (auto move : moves)
+    {
+        auto undo = position.DoMove(move);
+        out.push_back({move, Perft(position, depth - 1, table)});
+        position.UndoMove(move, undo);
+    }
+
+    return out;
+}
+
+std::vector<PerftDivision>
+ParallelPerftDivide(const Position &position, int depth, int threads, PerftTable *table)
+{
+    // Not worth spinning up threads for
+    if (threads <= 1 || depth < 3)
+    {
+        auto copy = position;
+        return PerftDivide(copy, depth, table);
+    }
+
+    // One job per reply to every root move
+    struct Job
+    {
+        std::size_t root;
+        Move reply;
+    };
+
+    MoveList roots;
+    GenerateLegalMoves(position, roots);
+
+    std::vector<Job> jobs;
+    for (std::size_t root = 0; root < roots.GetSize(); root++)
+    {
+        auto after_root = position;
+        after_root.DoMove(roots[root]);
+
+        MoveList replies;
+        GenerateLegalMoves(after_root, replies);
+        for (auto reply : replies)
+        {
+            jobs.push_back({root, reply});
+        }
+    }
+
+    auto counts = std::make_unique<std::atomic<std::uint64_t>[]>(roots.GetSize());
+    std::atomic<std::size_t> next_job = 0;
+    auto work = [&]() {
+        for (auto i = next_job++; i < jobs.size(); i = next_job++)
+        {
+            auto copy = position;
+            copy.DoMove(roots[jobs[i].root]);
+            copy.DoMove(jobs[i].reply);
+            counts[jobs[i].root] += Perft(copy, depth - 2, table);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (auto i = 0; i < threads; i++)
+    {
+        workers.emplace_back(work);
+    }
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    std::vector<PerftDivision> out;
+    out.reserve(roots.GetSize());
+    for (std::size_t root = 0; root < roots.GetSize(); root++)
+    {
+        out.push_back({roots[root], counts[root].load()});
+    }
+
+    return out;
+}
+} // namespace Game
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "move.h"
+#include "position.h"
+#include "zobrist.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace Game
+{
+struct PerftDivision
+{
+    Move move;
+    std::uint64_t nodes;
+};
+
+// Caches subtree node counts by (position, depth). Any number of threads can probe and store at
+// the same time without locks: every entry keeps its key XOR-ed with its data, so an entry torn by
+// two racing writers no longer matches any key and simply reads as a miss.
+class PerftTable
+{
+  public:
+    // Rounded down to a power of two number of entries
+    explicit PerftTable(std::size_t size_mb);
+    PerftTable(const PerftTable &other) = delete;
+    PerftTable &operator=(const PerftTable &other) = delete;
+
+    [[nodiscard]] std::optional<std::uint64_t> Probe(ZobristKey key, int depth) const;
+    // Always replaces whatever was in the slot
+    void Store(ZobristKey key, int depth, std::uint64_t nodes);
+
+  private:
+    struct Entry
+    {
+        std::atomic<std::uint64_t> check;
+        // Node count in the upper 56 bits, depth in the lower 8
+        std::atomic<std::uint64_t> data;
+    };
+
+    std::unique_ptr<Entry[]> m_entries;
+    std::size_t m_mask;
+};
+
+// Counts the leaves of the legal move tree `depth` plies deep. Comparing against known counts is
+// the standard way to catch move generation bugs. The position is left as it was found. Subtree
+// counts are cached in `table`, if given
+[[nodiscard]] std::uint64_t Perft(Position &position, int depth, PerftTable *table = nullptr);
+
+// Same as `Perft`, but gives up and returns nothing once `deadline` has passed
+[[nodiscard]] std::optional<std::uint64_t> Perft(
+    Position &position, int depth, std::chrono::steady_clock::time_point deadline,
+    PerftTable *table = nullptr
+);
+
+// Same as `Perft`, broken down by root move. Handy for narrowing down which move a wrong count
+// comes from, by comparing against another engine's output
+[[nodiscard]] std::vector<PerftDivision>
+PerftDivide(Position &position, int depth, PerftTable *table = nullptr);
+
+// Same as `PerftDivide`, with the work spread over `threads` threads. Subtrees are split two plies
+// deep, so even positions with only a handful of root moves keep every thread busy. The table, if
+// given, is shared by all of them
+[[nodiscard]] std::vector<PerftDivision>
+ParallelPerftDivide(const Position &position, int depth, int threads, PerftTable *table = nullptr);
+} // namespace Game
@@ -0,0 +1,411 @@
+#include "pgn.h"
+#include "notation.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace Game
+{
+[[nodiscard]] static bool is_whitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+[[nodiscard]] static bool is_alphanumeric(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+// Letters, digits and the punctuation found in SAN, results and tag names. Move suffix
+// annotations ("!?") are kept with the move, `ParseSAN` ignores them
+[[nodiscard]] static bool is_symbol_continuation(char c)
+{
+    switch (c)
+    {
+        case '_':
+        case '+':
+        case '#':
+        case '=':
+        case ':':
+        case '-':
+        case '/':
+        case '!':
+        case '?':
+            return true;
+        default:
+            return is_alphanumeric(c);
+    }
+}
+
+[[nodiscard]] static bool is_result(std::string_view symbol)
+{
+    return symbol == "1-0" || symbol == "0-1" || symbol == "1/2-1/2";
+}
+
+[[nodiscard]] static bool is_move_number(std::string_view symbol)
+{
+    return std::all_of(symbol.begin(), symbol.end(), [](char c) { return c >= '0' && c <= '9'; });
+}
+
+PgnLexer::PgnLexer(std::string_view text) : m_text(text), m_offset(0)
+{
+}
+
+PgnToken PgnLexer::Next()
+{
+    _SkipIgnored();
+    if (m_offset >= m_text.size())
+    {
+        return {PgnTokenKind::End, {}};
+    }
+
+    auto start = m_offset;
+    auto single = [this, start](PgnTokenKind kind) {
+        m_offset++;
+        return PgnToken{kind, m_text.substr(start, 1)};
+    };
+
+    switch (m_text[start])
+    {
+        case '"':
+        {
+            auto end = start + 1;
+            while (end < m_text.size() && m_text[end] != '"')
+            {
+                end += m_text[end] == '\\' ? 2 : 1;
+            }
+
+            end = std::min(end, m_text.size());
+            m_offset = std::min(end + 1, m_text.size());
+            return {PgnTokenKind::String, m_text.substr(start + 1, end - start - 1)};
+        }
+        case '.':
+            return single(PgnTokenKind::Period);
+        case '*':
+            return single(PgnTokenKind::Asterisk);
+        case '[':
+            return single(PgnTokenKind::LeftBracket);
+        case ']':
+            return single(PgnTokenKind::RightBracket);
+        case '(':
+            return single(PgnTokenKind::LeftParen);
+        case ')':
+            return single(PgnTokenKind::RightParen);
+        case '$':
+        {
+            auto end = start + 1;
+            while (end < m_text.size() && m_text[end] >= '0' && m_text[end] <= '9')
+            {
+                end++;
+            }
+
+            m_offset = end;
+            return {PgnTokenKind::Nag, m_text.substr(start + 1, end - start - 1)};
+        }
+        default:
+            break;
+    }
+
+    if (!is_alphanumeric(m_text[start]))
+    {
+        return single(PgnTokenKind::Invalid);
+    }
+
+    auto end = start + 1;
+    while (end < m_text.size() && is_symbol_continuation(m_text[end]))
+    {
+        end++;
+    }
+
+    m_offset = end;
+    return {PgnTokenKind::Symbol, m_text.substr(start, end - start)};
+}
+
+void PgnLexer::_SkipIgnored()
+{
+    while (m_offset < m_text.size())
+    {
+        auto c = m_text[m_offset];
+        if (is_whitespace(c))
+        {
+            m_offset++;
+            continue;
+        }
+
+        std::size_t end;
+        if (c == '{')
+        {
+            end = m_text.find('}', m_offset);
+        }
+        else if (c == ';' || (c == '%' && (m_offset == 0 || m_text[m_offset - 1] == '\n')))
+        {
+            end = m_text.find('\n', m_offset);
+        }
+        else
+        {
+            return;
+        }
+
+        m_offset = end == std::string_view::npos ? m_text.size() : end + 1;
+    }
+}
+
+std::string_view PgnGame::GetTag(std::string_view name) const
+{
+    for (const auto &tag : tags)
+    {
+        if (tag.name == name)
+        {
+            return tag.value;
+        }
+    }
+
+    return {};
+}
+
+// Start of the line `offset` is on, if only blanks come before it on that line
+[[nodiscard]] static std::optional<std::size_t> line_start_before(
+    std::string_view text, std::size_t offset
+)
+{
+    while (offset > 0 && (text[offset - 1] == ' ' || text[offset - 1] == '\t'))
+    {
+        offset--;
+    }
+
+    if (offset > 0 && text[offset - 1] != '\n')
+    {
+        return std::nullopt;
+    }
+
+    return offset;
+}
+
+// Just past the end of the line `offset` is on
+[[nodiscard]] static std::size_t next_line(std::string_view text, std::size_t offset)
+{
+    auto newline = text.find('\n', offset);
+    return newline == std::string_view::npos ? text.size() : newline + 1;
+}
+
+std::size_t FindPgnGameStart(std::string_view text, std::size_t from)
+{
+    for (auto offset = text.find_first_of("[{;", from); offset != std::string_view::npos;
+         offset = text.find_first_of("[{;", offset))
+    {
+        if (text[offset] == '{')
+        {
+            auto end = text.find('}', offset + 1);
+            if (end == std::string_view::npos)
+            {
+                break;
+            }
+            offset = end + 1;
+            continue;
+        }
+
+        if (text[offset] == ';')
+        {
+            offset = next_line(text, offset);
+            continue;
+        }
+
+        auto line_start = line_start_before(text, offset);
+        if (!line_start.has_value())
+        {
+            offset++;
+            continue;
+        }
+
+        if (line_start.value() == 0)
+        {
+            return offset;
+        }
+
+        // Blank lines and movetext end a game, another tag pair continues the current one
+        auto previous_end = line_start.value() - 1;
+        std::size_t previous_start = 0;
+        if (previous_end > 0)
+        {
+            auto newline = text.rfind('\n', previous_end - 1);
+            previous_start = newline == std::string_view::npos ? 0 : newline + 1;
+        }
+
+        auto previous = text.substr(previous_start, previous_end - previous_start);
+        auto first = previous.find_first_not_of(" \t");
+        if (first == std::string_view::npos || previous[first] != '[')
+        {
+            return offset;
+        }
+
+        // The rest of the tag pair, its value may hold braces or semicolons
+        offset = next_line(text, offset);
+    }
+
+    return text.size();
+}
+
+// Start of the game after the one at `start`. At the very start of the text, that's the first
+// game, unless one starts right there
+[[nodiscard]] static std::size_t next_game_start(std::string_view text, std::size_t start)
+{
+    if (start == 0)
+    {
+        auto first = FindPgnGameStart(text, 0);
+        if (first != 0)
+        {
+            return first;
+        }
+    }
+
+    // Searching from inside the game's first tag pair could mistake a brace in it for a comment
+    return FindPgnGameStart(text, next_line(text, start));
+}
+
+PgnGame ParsePgnGame(std::string_view text, std::size_t offset)
+{
+    PgnGame result{offset, {}, {}, nullptr, {}};
+
+    PgnLexer lexer(text);
+    auto token = lexer.Next();
+    while (token.kind == PgnTokenKind::LeftBracket)
+    {
+        auto name = lexer.Next();
+        auto value = lexer.Next();
+        auto close = lexer.Next();
+        if (name.kind != PgnTokenKind::Symbol || value.kind != PgnTokenKind::String ||
+            close.kind != PgnTokenKind::RightBracket)
+        {
+            result.error = "malformed tag pair";
+            return result;
+        }
+
+        result.tags.push_back({name.text, value.text});
+        token = lexer.Next();
+    }
+
+    auto fen = result.GetTag("FEN");
+    result.game = fen.empty() ? std::make_unique<Game>() : Game::FromFEN(fen);
+    if (result.game == nullptr)
+    {
+        result.error = "invalid FEN tag";
+        return result;
+    }
+
+    // Only the main line is replayed, everything between parentheses is skipped
+    auto variation_depth = 0;
+    for (; token.kind != PgnTokenKind::End; token = lexer.Next())
+    {
+        if (token.kind == PgnTokenKind::LeftParen)
+        {
+            variation_depth++;
+            continue;
+        }
+
+        if (token.kind == PgnTokenKind::RightParen)
+        {
+            variation_depth = std::max(variation_depth - 1, 0);
+            continue;
+        }
+
+        if (variation_depth > 0 || token.kind == PgnTokenKind::Period ||
+            token.kind == PgnTokenKind::Nag)
+        {
+            continue;
+        }
+
+        if (token.kind == PgnTokenKind::Asterisk ||
+            (token.kind == PgnTokenKind::Symbol && is_result(token.text)))
+        {
+            result.result = token.text;
+            break;
+        }
+
+        if (token.kind != PgnTokenKind::Symbol)
+        {
+            result.error = "unexpected '" + std::string(token.text) + "'";
+            break;
+        }
+
+        if (is_move_number(token.text))
+        {
+            continue;
+        }
+
+        // A recorded game going on past a repetition or fifty moves means nobody claimed the draw
+        static_cast<void>(result.game->DeclineDraw());
+        auto move = Notation::ParseSAN(result.game->GetPosition(), token.text);
+        if (!move.has_value() || !result.game->MakeMove(move.value()))
+        {
+            auto ply = result.game->GetMoves().size() + 1;
+            result.error = "illegal move '" + std::string(token.text) + "' at ply " +
+                           std::to_string(ply);
+            break;
+        }
+    }
+
+    return result;
+}
+
+void ParsePgnGames(
+    std::string_view text, int threads, const std::function<void(PgnGame &game)> &on_game
+)
+{
+    threads = std::max(threads, 1);
+
+    // Several chunks per thread so that one full of long games doesn't hold up the rest, but not
+    // so small that finding the boundaries starts to matter
+    constexpr std::size_t min_chunk_size = 256 * 1024;
+    auto chunk_count = std::clamp<std::size_t>(
+        text.size() / min_chunk_size, 1, static_cast<std::size_t>(threads) * 16
+    );
+
+    // Whether some offset is inside a comment is only known from scanning up to it, so chunk
+    // boundaries are found going from game to game. Skipping over games is cheap next to parsing
+    auto chunk_size = text.size() / chunk_count;
+    std::vector<std::size_t> bounds{0};
+    for (auto start = next_game_start(text, 0); start < text.size();
+         start = next_game_start(text, start))
+    {
+        if (start >= chunk_size * bounds.size())
+        {
+            bounds.push_back(start);
+        }
+    }
+    bounds.push_back(text.size());
+
+    std::atomic<std::size_t> next_chunk = 0;
+    auto work = [&]() {
+        for (auto chunk = next_chunk++; chunk + 1 < bounds.size(); chunk = next_chunk++)
+        {
+            // Games can't be found past the end of the chunk, that's the next chunk's first game
+            auto chunk_text = text.substr(0, bounds[chunk + 1]);
+            for (auto start = bounds[chunk]; start < chunk_text.size();)
+            {
+                auto end = next_game_start(chunk_text, start);
+                auto game_text = chunk_text.substr(start, end - start);
+                if (std::any_of(game_text.begin(), game_text.end(), [](char c) {
+                        return !is_whitespace(c);
+                    }))
+                {
+                    auto game = ParsePgnGame(game_text, start);
+                    on_game(game);
+                }
+                start = end;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (auto i = 1; i < threads; i++)
+    {
+        workers.emplace_back(work);
+    }
+
+    work();
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+} // namespace Game
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "game.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Game
+{
+enum class PgnTokenKind
+{
+    // Between double quotes, with the quotes stripped. Escapes are left as they are
+    String,
+    // Move numbers, SAN moves, tag names and results
+    Symbol,
+    Period,
+    // Unknown result
+    Asterisk,
+    LeftBracket,
+    RightBracket,
+    LeftParen,
+    RightParen,
+    // Numeric annotation glyph, e.g. "$1". The text doesn't include the "$"
+    Nag,
+    // Anything else, as a single character
+    Invalid,
+    End,
+};
+
+struct PgnToken
+{
+    PgnTokenKind kind;
+    // Points into the lexed text, nothing is copied
+    std::string_view text;
+};
+
+// Splits PGN text into tokens, skipping whitespace, comments ("{...}" and ";" to the end of the
+// line) and "%" escape lines
+class PgnLexer
+{
+  public:
+    explicit PgnLexer(std::string_view text);
+
+    [[nodiscard]] PgnToken Next();
+
+  private:
+    std::string_view m_text;
+    std::size_t m_offset;
+
+    void _SkipIgnored();
+};
+
+struct PgnGame
+{
+    // Where the game starts, as an offset into the whole text
+    std::size_t offset;
+    // Views into the text, valid for as long as it is
+    std::vector<PgnTag> tags;
+    std::string_view result;
+    // The game after every move that could be replayed. Null if the starting position (the FEN
+    // tag) isn't valid
+    std::unique_ptr<Game> game;
+    // Empty if every move was replayed
+    std::string error;
+
+    // Value of the given tag, empty if there is none
+    [[nodiscard]] std::string_view GetTag(std::string_view name) const;
+};
+
+// Offset of the first game starting at or after `from`, or the text's size. A game starts with a
+// line opening a tag pair, unless the line before it is a tag pair too. Comments are skipped, a
+// wrapped "[%clk ...]" annotation can look just like a tag pair. So `from` can't be inside one,
+// or inside a tag pair, which can hold braces: the start of the text or of a line is safe
+[[nodiscard]] std::size_t FindPgnGameStart(std::string_view text, std::size_t from);
+
+// Reads the tags of a single game and replays its main line through `Game::MakeMove`. Variations,
+// comments and annotation glyphs are skipped. Repetitions and the fifty-move rule don't end the
+// replay, unclaimed draws are declined, see `Game::DeclineDraw`
+[[nodiscard]] PgnGame ParsePgnGame(std::string_view text, std::size_t offset = 0);
+
+// Splits the text into chunks at game boundaries and parses them on `threads` worker threads.
+// `on_game` is called from the workers, concurrently and in no particular order
+void ParsePgnGames(
+    std::string_view text, int threads, const std::function<void(PgnGame &game)> &on_game
+);
+} // namespace Game
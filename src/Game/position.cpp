@@ -0,0 +1,609 @@
+#include "position.h"
+#include "../Util/debug.h"
+#include "notation.h"
+#include <cassert>
+#include <charconv>
+#include <utility>
+
+namespace Game
+{
+// `Position::m_board` value of an empty square
+constexpr std::uint8_t no_piece = Piece::s_raw_count;
+
+std::uint8_t CastlingRights::LostOn(Square square)
+{
+    switch (square)
+    {
+        case MakeSquare(0, 0):
+            return WhiteLong;
+        case MakeSquare(0, 4):
+            return WhiteShort | WhiteLong;
+        case MakeSquare(0, 7):
+            return WhiteShort;
+        case MakeSquare(7, 0):
+            return BlackLong;
+        case MakeSquare(7, 4):
+            return BlackShort | BlackLong;
+        case MakeSquare(7, 7):
+            return BlackShort;
+        default:
+            return None;
+    }
+}
+
+PieceType PromotedPieceType(PromotionKind kind)
+{
+    switch (kind)
+    {
+        case PromotionKind::Knight:
+            return PieceType::Knight;
+        case PromotionKind::Bishop:
+            return PieceType::Bishop;
+        case PromotionKind::Rook:
+            return PieceType::Rook;
+        case PromotionKind::Queen:
+            return PieceType::Queen;
+    }
+
+    return PieceType::Queen;
+}
+
+std::pair<Square, Square> CastlingRookSquares(Move move)
+{
+    auto rank = RankOf(move.GetFrom());
+    if (move.GetCastleKind() == CastleKind::Short)
+    {
+        return {MakeSquare(rank, 7), MakeSquare(rank, 5)};
+    }
+
+    return {MakeSquare(rank, 0), MakeSquare(rank, 3)};
+}
+
+Position::Position()
+    : m_pieces{},
+      m_occupancy{},
+      m_side_to_move(Color::White),
+      m_castling_rights(CastlingRights::None),
+      m_en_passant(NoSquare),
+      m_halfmove_clock(0),
+      m_fullmove_number(1),
+      m_hash(0)
+{
+    m_board.fill(no_piece);
+}
+
+Position Position::StartingPosition()
+{
+    static const PieceType back_rank[8] = {
+        PieceType::Rook,
+        PieceType::Knight,
+        PieceType::Bishop,
+        PieceType::Queen,
+        PieceType::King,
+        PieceType::Bishop,
+        PieceType::Knight,
+        PieceType::Rook,
+    };
+
+    Position position;
+    for (auto file = 0; file < 8; file++)
+    {
+        position.PutPiece(Color::White, back_rank[file], MakeSquare(0, file));
+        position.PutPiece(Color::White, PieceType::Pawn, MakeSquare(1, file));
+        position.PutPiece(Color::Black, PieceType::Pawn, MakeSquare(6, file));
+        position.PutPiece(Color::Black, back_rank[file], MakeSquare(7, file));
+    }
+
+    position.SetCastlingRights(CastlingRights::All);
+    return position;
+}
+
+// Splits off the next space-separated FEN field, empty once there are none left
+[[nodiscard]] static std::string_view next_fen_field(std::string_view &rest)
+{
+    auto start = rest.find_first_not_of(' ');
+    if (start == std::string_view::npos)
+    {
+        rest = {};
+        return {};
+    }
+
+    rest.remove_prefix(start);
+    auto field = rest.substr(0, rest.find(' '));
+    rest.remove_prefix(field.size());
+    return field;
+}
+
+[[nodiscard]] static std::optional<Piece> piece_from_fen(char c)
+{
+    static constexpr char names[] = "PNBRQK";
+    auto color = (c >= 'a' && c <= 'z') ? Color::Black : Color::White;
+    auto upper = color == Color::Black ? static_cast<char>(c - 'a' + 'A') : c;
+    for (auto type = 0; type < PieceTypeCount; type++)
+    {
+        if (names[type] == upper)
+        {
+            return Piece(static_cast<PieceType>(type), color);
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::optional<Position> Position::FromFEN(std::string_view fen)
+{
+    auto scope = Util::Debugger::CreateScope("Position::FromFEN");
+
+    Position position;
+    auto rest = fen;
+
+    // Piece placement, from rank 8 down to rank 1
+    auto rank = 7;
+    auto file = 0;
+    for (auto c : next_fen_field(rest))
+    {
+        if (c == '/')
+        {
+            if (file != 8 || rank == 0)
+            {
+                scope.Debug("Bad rank length\n");
+                return std::nullopt;
+            }
+
+            rank--;
+            file = 0;
+        }
+        else if (c >= '1' && c <= '8')
+        {
+            file += c - '0';
+        }
+        else
+        {
+            auto piece = piece_from_fen(c);
+            if (!piece.has_value() || file >= 8)
+            {
+                scope.Debug("Bad piece placement\n");
+                return std::nullopt;
+            }
+
+            position.PutPiece(piece->GetColor(), piece->GetType(), MakeSquare(rank, file++));
+        }
+
+        if (file > 8)
+        {
+            scope.Debug("Bad rank length\n");
+            return std::nullopt;
+        }
+    }
+
+    if (rank != 0 || file != 8 ||
+        PopCount(position.GetPieces(Color::White, PieceType::King)) != 1 ||
+        PopCount(position.GetPieces(Color::Black, PieceType::King)) != 1)
+    {
+        scope.Debug("Incomplete board or missing kings\n");
+        return std::nullopt;
+    }
+
+    // Pawns promote on the last rank and never go back to their first, move generation relies on
+    // neither ever holding one
+    if (position.GetPieces(PieceType::Pawn) & (Rank1Bitboard | Rank8Bitboard))
+    {
+        scope.Debug("Pawn on a back rank\n");
+        return std::nullopt;
+    }
+
+    auto side = next_fen_field(rest);
+    if (side != "w" && side != "b")
+    {
+        scope.Debug("Bad side to move\n");
+        return std::nullopt;
+    }
+    position.SetSideToMove(side == "w" ? Color::White : Color::Black);
+
+    // Whoever just moved can't have left their king in check
+    auto us = position.GetSideToMove();
+    auto them_king = position.GetKingSquare(OppositeColor(us));
+    if (position.IsSquareAttacked(them_king, us, position.GetOccupancy()))
+    {
+        scope.Debug("Side not to move is in check\n");
+        return std::nullopt;
+    }
+
+    auto castling = next_fen_field(rest);
+    if (castling.empty())
+    {
+        scope.Debug("Missing castling rights\n");
+        return std::nullopt;
+    }
+
+    std::uint8_t rights = CastlingRights::None;
+    for (auto c : castling == "-" ? std::string_view() : castling)
+    {
+        switch (c)
+        {
+            case 'K':
+                rights |= CastlingRights::WhiteShort;
+                break;
+            case 'Q':
+                rights |= CastlingRights::WhiteLong;
+                break;
+            case 'k':
+                rights |= CastlingRights::BlackShort;
+                break;
+            case 'q':
+                rights |= CastlingRights::BlackLong;
+                break;
+            default:
+                scope.Debug("Bad castling rights\n");
+                return std::nullopt;
+        }
+    }
+
+    // Like the en passant square below, a right that couldn't ever be used is dropped rather than
+    // kept: castling needs the king and that side's rook still on their home squares
+    for (auto color : {Color::White, Color::Black})
+    {
+        auto rank = color == Color::White ? 0 : 7;
+        auto home = [&position, color, rank](PieceType type, int file) {
+            return (position.GetPieces(color, type) & SquareBitboard(MakeSquare(rank, file))) != 0;
+        };
+        if (!home(PieceType::King, 4) || !home(PieceType::Rook, 7))
+        {
+            rights &= ~CastlingRights::For(color, CastleKind::Short);
+        }
+        if (!home(PieceType::King, 4) || !home(PieceType::Rook, 0))
+        {
+            rights &= ~CastlingRights::For(color, CastleKind::Long);
+        }
+    }
+    position.SetCastlingRights(rights);
+
+    auto en_passant = next_fen_field(rest);
+    if (en_passant != "-")
+    {
+        // The square behind a pawn of the side that just moved, on its third rank
+        auto passed_rank = us == Color::White ? '6' : '3';
+        if (en_passant.size() != 2 || en_passant[0] < 'a' || en_passant[0] > 'h' ||
+            en_passant[1] != passed_rank)
+        {
+            scope.Debug("Bad en passant square\n");
+            return std::nullopt;
+        }
+
+        auto square = MakeSquare(en_passant[1] - '1', en_passant[0] - 'a');
+        // The pawn that just double pushed, and the two squares it went through
+        Square landed = us == Color::White ? square - 8 : square + 8;
+        Square started = us == Color::White ? square + 8 : square - 8;
+        auto passed_through = SquareBitboard(square) | SquareBitboard(started);
+        if (!(position.GetPieces(OppositeColor(us), PieceType::Pawn) & SquareBitboard(landed)) ||
+            (position.GetOccupancy() & passed_through))
+        {
+            scope.Debug("No pawn made the double push\n");
+            return std::nullopt;
+        }
+
+        // Same as `DoMove`, the square only counts if a pawn can actually take on it
+        if (PawnAttacks(OppositeColor(us), square) & position.GetPieces(us, PieceType::Pawn))
+        {
+            position.SetEnPassantSquare(square);
+        }
+    }
+
+    // The clocks are optional, plenty of EPD-ish strings leave them out
+    // Parsed straight into the type they're stored as, anything that doesn't fit is rejected
+    // rather than wrapped around
+    std::uint16_t clocks[2] = {0, 1};
+    for (auto &clock : clocks)
+    {
+        auto field = next_fen_field(rest);
+        if (field.empty())
+        {
+            break;
+        }
+
+        auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), clock);
+        if (error != std::errc() || end != field.data() + field.size())
+        {
+            scope.Debug("Bad move clock\n");
+            return std::nullopt;
+        }
+    }
+    position.SetHalfmoveClock(clocks[0]);
+    position.SetFullmoveNumber(clocks[1]);
+
+    return position;
+}
+
+std::string Position::ToFEN() const
+{
+    char buffer[Notation::MaxFENLength];
+    auto end = Notation::WriteFEN(buffer, buffer + sizeof(buffer), *this).ptr;
+    return std::string(buffer, end);
+}
+
+int Position::_Index(Color color, PieceType type)
+{
+    return Piece(type, color).GetRaw();
+}
+
+Bitboard Position::GetPieces(Color color, PieceType type) const
+{
+    return m_pieces[_Index(color, type)];
+}
+
+Bitboard Position::GetPieces(Color color) const
+{
+    return m_occupancy[static_cast<int>(color)];
+}
+
+Bitboard Position::GetPieces(PieceType type) const
+{
+    return GetPieces(Color::White, type) | GetPieces(Color::Black, type);
+}
+
+Bitboard Position::GetOccupancy() const
+{
+    return m_occupancy[0] | m_occupancy[1];
+}
+
+std::optional<Piece> Position::GetPieceAt(Square square) const
+{
+    auto raw = m_board[square];
+    if (raw == no_piece)
+    {
+        return std::nullopt;
+    }
+
+    return Piece::FromRaw(raw);
+}
+
+Square Position::GetKingSquare(Color color) const
+{
+    return Lsb(GetPieces(color, PieceType::King));
+}
+
+Color Position::GetSideToMove() const
+{
+    return m_side_to_move;
+}
+
+std::uint8_t Position::GetCastlingRights() const
+{
+    return m_castling_rights;
+}
+
+bool Position::HasCastlingRight(Color color, CastleKind kind) const
+{
+    return m_castling_rights & CastlingRights::For(color, kind);
+}
+
+Square Position::GetEnPassantSquare() const
+{
+    return m_en_passant;
+}
+
+int Position::GetHalfmoveClock() const
+{
+    return m_halfmove_clock;
+}
+
+int Position::GetFullmoveNumber() const
+{
+    return m_fullmove_number;
+}
+
+ZobristKey Position::GetHash() const
+{
+    return m_hash;
+}
+
+Bitboard Position::GetAttackersTo(Square square, Bitboard occupancy) const
+{
+    auto diagonal = GetPieces(PieceType::Bishop) | GetPieces(PieceType::Queen);
+    auto straight = GetPieces(PieceType::Rook) | GetPieces(PieceType::Queen);
+
+    // Pawns are the one asymmetric case: white pawns attacking the square sit where a black pawn
+    // on it would attack, and vice versa
+    return (PawnAttacks(Color::Black, square) & GetPieces(Color::White, PieceType::Pawn)) |
+           (PawnAttacks(Color::White, square) & GetPieces(Color::Black, PieceType::Pawn)) |
+           (KnightAttacks(square) & GetPieces(PieceType::Knight)) |
+           (KingAttacks(square) & GetPieces(PieceType::King)) |
+           (BishopAttacks(square, occupancy) & diagonal) |
+           (RookAttacks(square, occupancy) & straight);
+}
+
+bool Position::IsSquareAttacked(Square square, Color by, Bitboard occupancy) const
+{
+    return GetAttackersTo(square, occupancy) & GetPieces(by);
+}
+
+UndoInfo Position::DoMove(Move move)
+{
+    UndoInfo undo{std::nullopt, m_castling_rights, m_en_passant, m_halfmove_clock, m_hash};
+
+    auto us = m_side_to_move;
+    auto them = OppositeColor(us);
+    auto from = move.GetFrom();
+    auto to = move.GetTo();
+    auto moving = GetPieceAt(from)->GetType();
+
+    m_halfmove_clock++;
+    SetEnPassantSquare(NoSquare);
+
+    if (move.IsEnPassant())
+    {
+        RemovePiece(them, PieceType::Pawn, move.GetPassantedSquare());
+        undo.captured = PieceType::Pawn;
+    }
+    else
+    {
+        auto captured = GetPieceAt(to);
+        if (captured.has_value())
+        {
+            RemovePiece(them, captured->GetType(), to);
+            undo.captured = captured->GetType();
+            m_halfmove_clock = 0;
+        }
+    }
+
+    if (move.IsPromotion())
+    {
+        RemovePiece(us, PieceType::Pawn, from);
+        PutPiece(us, PromotedPieceType(move.GetPromotionKind()), to);
+    }
+    else
+    {
+        MovePiece(us, moving, from, to);
+    }
+
+    if (move.IsCastle())
+    {
+        auto [rook_from, rook_to] = CastlingRookSquares(move);
+        MovePiece(us, PieceType::Rook, rook_from, rook_to);
+    }
+
+    if (moving == PieceType::Pawn)
+    {
+        m_halfmove_clock = 0;
+
+        // The square skipped by a double push. Only worth recording if an enemy pawn can actually
+        // capture onto it, which keeps otherwise identical positions identical
+        if (to - from == 16 || from - to == 16)
+        {
+            Square skipped = (from + to) / 2;
+            if (PawnAttacks(us, skipped) & GetPieces(them, PieceType::Pawn))
+            {
+                SetEnPassantSquare(skipped);
+            }
+        }
+    }
+
+    // Moving a king or rook off its home square (or capturing a rook on it) loses castling rights
+    RemoveCastlingRights(CastlingRights::LostOn(from) | CastlingRights::LostOn(to));
+
+    if (us == Color::Black)
+    {
+        m_fullmove_number++;
+    }
+    SetSideToMove(them);
+
+    return undo;
+}
+
+void Position::UndoMove(Move move, const UndoInfo &undo)
+{
+    auto them = m_side_to_move;
+    auto us = OppositeColor(them);
+    auto from = move.GetFrom();
+    auto to = move.GetTo();
+
+    m_side_to_move = us;
+    if (us == Color::Black)
+    {
+        m_fullmove_number--;
+    }
+
+    if (move.IsCastle())
+    {
+        auto [rook_from, rook_to] = CastlingRookSquares(move);
+        MovePiece(us, PieceType::Rook, rook_to, rook_from);
+    }
+
+    if (move.IsPromotion())
+    {
+        RemovePiece(us, PromotedPieceType(move.GetPromotionKind()), to);
+        PutPiece(us, PieceType::Pawn, from);
+    }
+    else
+    {
+        MovePiece(us, GetPieceAt(to)->GetType(), to, from);
+    }
+
+    if (undo.captured.has_value())
+    {
+        auto square = move.IsEnPassant() ? move.GetPassantedSquare() : to;
+        PutPiece(them, undo.captured.value(), square);
+    }
+
+    m_castling_rights = undo.castling_rights;
+    m_en_passant = undo.en_passant;
+    m_halfmove_clock = undo.halfmove_clock;
+    // Everything above also updated the hash on the way, but it's simpler to just restore it
+    m_hash = undo.hash;
+}
+
+void Position::PutPiece(Color color, PieceType type, Square square)
+{
+    auto bitboard = SquareBitboard(square);
+    m_pieces[_Index(color, type)] |= bitboard;
+    m_occupancy[static_cast<int>(color)] |= bitboard;
+    m_board[square] = static_cast<std::uint8_t>(_Index(color, type));
+    m_hash ^= Zobrist::PieceKey(Piece(type, color), square);
+}
+
+void Position::RemovePiece(Color color, PieceType type, Square square)
+{
+    auto bitboard = SquareBitboard(square);
+    m_pieces[_Index(color, type)] &= ~bitboard;
+    m_occupancy[static_cast<int>(color)] &= ~bitboard;
+    m_board[square] = no_piece;
+    m_hash ^= Zobrist::PieceKey(Piece(type, color), square);
+}
+
+void Position::MovePiece(Color color, PieceType type, Square from, Square to)
+{
+    auto bitboard = SquareBitboard(from) | SquareBitboard(to);
+    m_pieces[_Index(color, type)] ^= bitboard;
+    m_occupancy[static_cast<int>(color)] ^= bitboard;
+    m_board[to] = m_board[from];
+    m_board[from] = no_piece;
+    m_hash ^= Zobrist::PieceKey(Piece(type, color), from) ^
+              Zobrist::PieceKey(Piece(type, color), to);
+}
+
+void Position::SetSideToMove(Color color)
+{
+    if (color != m_side_to_move)
+    {
+        m_hash ^= Zobrist::SideKey();
+    }
+
+    m_side_to_move = color;
+}
+
+void Position::SetCastlingRights(std::uint8_t rights)
+{
+    m_hash ^= Zobrist::CastlingKey(m_castling_rights) ^ Zobrist::CastlingKey(rights);
+    m_castling_rights = rights;
+}
+
+void Position::RemoveCastlingRights(std::uint8_t rights)
+{
+    SetCastlingRights(m_castling_rights & ~rights);
+}
+
+void Position::SetEnPassantSquare(Square square)
+{
+    if (m_en_passant != NoSquare)
+    {
+        m_hash ^= Zobrist::EnPassantKey(m_en_passant);
+    }
+
+    if (square != NoSquare)
+    {
+        m_hash ^= Zobrist::EnPassantKey(square);
+    }
+
+    m_en_passant = square;
+}
+
+void Position::SetHalfmoveClock(int clock)
+{
+    m_halfmove_clock = static_cast<std::uint16_t>(clock);
+}
+
+void Position::SetFullmoveNumber(int number)
+{
+    m_fullmove_number = static_cast<std::uint16_t>(number);
+}
+} // namespace Game
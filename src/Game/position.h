@@ -0,0 +1,136 @@
+#pragma once
+
+#include "Piece/piece.h"
+#include "bitboard.h"
+#include "coordinates.h"
+#include "move.h"
+#include "zobrist.h"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace Game
+{
+// Everything `Position::DoMove` throws away, so that `Position::UndoMove` can restore it
+struct UndoInfo
+{
+    std::optional<PieceType> captured;
+    std::uint8_t castling_rights;
+    Square en_passant;
+    std::uint16_t halfmove_clock;
+    ZobristKey hash;
+};
+
+namespace CastlingRights
+{
+constexpr std::uint8_t None = 0;
+constexpr std::uint8_t WhiteShort = 1 << 0;
+constexpr std::uint8_t WhiteLong = 1 << 1;
+constexpr std::uint8_t BlackShort = 1 << 2;
+constexpr std::uint8_t BlackLong = 1 << 3;
+constexpr std::uint8_t All = WhiteShort | WhiteLong | BlackShort | BlackLong;
+
+[[nodiscard]] constexpr std::uint8_t For(Color color, CastleKind kind)
+{
+    if (color == Color::White)
+    {
+        return kind == CastleKind::Short ? WhiteShort : WhiteLong;
+    }
+
+    return kind == CastleKind::Short ? BlackShort : BlackLong;
+}
+
+// Rights that are lost once anything moves from or to the given square (king and rook homes)
+[[nodiscard]] std::uint8_t LostOn(Square square);
+} // namespace CastlingRights
+
+// The piece a pawn turns into
+[[nodiscard]] PieceType PromotedPieceType(PromotionKind kind);
+// Home and destination squares of the rook that goes along with a castling king
+[[nodiscard]] std::pair<Square, Square> CastlingRookSquares(Move move);
+
+// Plain-value board state: one bitboard per piece type and color, plus everything else needed to
+// generate moves. Moves are applied in place and can be taken back, so "simulating" a move never
+// needs a copy.
+class Position
+{
+  public:
+    // An empty board, white to move, no castling rights
+    Position();
+
+    [[nodiscard]] static Position StartingPosition();
+    // Parses Forsyth-Edwards Notation. The move clocks may be left out. Returns nothing if the
+    // string is malformed, either side doesn't have exactly one king or the side that just moved
+    // is in check. An en passant square no pawn can capture on is dropped, like `DoMove` does
+    [[nodiscard]] static std::optional<Position> FromFEN(std::string_view fen);
+    // All six fields, always
+    [[nodiscard]] std::string ToFEN() const;
+
+    [[nodiscard]] Bitboard GetPieces(Color color, PieceType type) const;
+    [[nodiscard]] Bitboard GetPieces(Color color) const;
+    // Pieces of the given type, for both colors
+    [[nodiscard]] Bitboard GetPieces(PieceType type) const;
+    [[nodiscard]] Bitboard GetOccupancy() const;
+    [[nodiscard]] std::optional<Piece> GetPieceAt(Square square) const;
+    // Undefined if the given color has no king on the board
+    [[nodiscard]] Square GetKingSquare(Color color) const;
+
+    [[nodiscard]] Color GetSideToMove() const;
+    [[nodiscard]] std::uint8_t GetCastlingRights() const;
+    [[nodiscard]] bool HasCastlingRight(Color color, CastleKind kind) const;
+    // Square a pawn can capture onto en passant, or `NoSquare`
+    [[nodiscard]] Square GetEnPassantSquare() const;
+    [[nodiscard]] int GetHalfmoveClock() const;
+    [[nodiscard]] int GetFullmoveNumber() const;
+    // Zobrist key of the position. Equal positions (as far as repetitions go) have equal keys
+    [[nodiscard]] ZobristKey GetHash() const;
+
+    // Pieces of both colors attacking the given square, treating `occupancy` as the blockers.
+    // Works backwards from the target: a knight on the square would attack exactly the knights
+    // attacking it, and so on for every piece type
+    [[nodiscard]] Bitboard GetAttackersTo(Square square, Bitboard occupancy) const;
+    [[nodiscard]] bool IsSquareAttacked(Square square, Color by, Bitboard occupancy) const;
+
+    // Applies a move for the side to move, updating castling rights, en passant, clocks and the
+    // side to move. The move has to at least be pseudo-legal (see `Piece::GetPossibleMoves`), this
+    // does not check whether it leaves the king in check
+    UndoInfo DoMove(Move move);
+    // Takes back the last move made with `DoMove`, given what it returned
+    void UndoMove(Move move, const UndoInfo &undo);
+
+    void PutPiece(Color color, PieceType type, Square square);
+    void RemovePiece(Color color, PieceType type, Square square);
+    void MovePiece(Color color, PieceType type, Square from, Square to);
+
+    void SetSideToMove(Color color);
+    void SetCastlingRights(std::uint8_t rights);
+    void RemoveCastlingRights(std::uint8_t rights);
+    void SetEnPassantSquare(Square square);
+    void SetHalfmoveClock(int clock);
+    void SetFullmoveNumber(int number);
+
+  private:
+    [[nodiscard]] static int _Index(Color color, PieceType type);
+
+    std::array<Bitboard, 2 * PieceTypeCount> m_pieces;
+    std::array<Bitboard, 2> m_occupancy;
+    // What's on every square, as `Piece::GetRaw()`, so lookups don't have to go through all the
+    // bitboards. Kept as plain bytes so the whole position stays trivially copyable
+    std::array<std::uint8_t, 64> m_board;
+
+    Color m_side_to_move;
+    std::uint8_t m_castling_rights;
+    Square m_en_passant;
+    std::uint16_t m_halfmove_clock;
+    std::uint16_t m_fullmove_number;
+    // Kept up to date by every mutator, see `Zobrist`
+    ZobristKey m_hash;
+};
+
+// Copying a position is a plain memcpy
+static_assert(std::is_trivially_copyable_v<Position>);
+} // namespace Game
@@ -0,0 +1,31 @@
+#include "position_snapshot.h"
+
+namespace Game
+{
+PositionSnapshot::PositionSnapshot(const Position &position)
+    : m_position(std::make_shared<const Position>(position))
+{
+}
+
+const Position &PositionSnapshot::Get() const
+{
+    return *m_position;
+}
+
+const Position &PositionSnapshot::operator*() const
+{
+    return *m_position;
+}
+
+const Position *PositionSnapshot::operator->() const
+{
+    return m_position.get();
+}
+
+PositionSnapshot PositionSnapshot::AfterMove(Move move) const
+{
+    auto position = *m_position;
+    position.DoMove(move);
+    return PositionSnapshot(position);
+}
+} // namespace Game
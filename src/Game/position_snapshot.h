@@ -0,0 +1,28 @@
+#pragma once
+
+#include "move.h"
+#include "position.h"
+#include <memory>
+
+namespace Game
+{
+// An immutable position that can be shared freely. Copies only bump a reference count, and a
+// snapshot stays valid no matter what happens to the game or position it was taken from. Playing
+// a move never touches the original, it produces a new snapshot instead (copy on write).
+class PositionSnapshot
+{
+  public:
+    explicit PositionSnapshot(const Position &position);
+
+    [[nodiscard]] const Position &Get() const;
+    [[nodiscard]] const Position &operator*() const;
+    [[nodiscard]] const Position *operator->() const;
+
+    // A new snapshot with the given move played. Like `Position::DoMove`, the move isn't checked
+    // for legality
+    [[nodiscard]] PositionSnapshot AfterMove(Move move) const;
+
+  private:
+    std::shared_ptr<const Position> m_position;
+};
+} // namespace Game
@@ -0,0 +1,71 @@
+#include "zobrist.h"
+#include <array>
+
+namespace Game
+{
+struct ZobristKeys
+{
+    std::array<std::array<ZobristKey, 64>, Piece::s_raw_count> pieces;
+    ZobristKey side;
+    std::array<ZobristKey, 16> castling;
+    std::array<ZobristKey, 8> en_passant;
+};
+
+// splitmix64 with a fixed seed, so keys (and anything keyed by them) are the same on every run.
+// Runs at compile time
+[[nodiscard]] static constexpr ZobristKeys generate_keys()
+{
+    std::uint64_t state = 0x2545F4914F6CDD1DULL;
+    auto next = [&state]() {
+        auto z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    };
+
+    ZobristKeys keys{};
+    for (auto &piece : keys.pieces)
+    {
+        for (auto &key : piece)
+        {
+            key = next();
+        }
+    }
+
+    keys.side = next();
+    // No castling rights at all contributes nothing, so an empty position hashes to zero
+    for (std::size_t rights = 1; rights < keys.castling.size(); rights++)
+    {
+        keys.castling[rights] = next();
+    }
+
+    for (auto &key : keys.en_passant)
+    {
+        key = next();
+    }
+
+    return keys;
+}
+
+static constexpr ZobristKeys keys = generate_keys();
+
+ZobristKey Zobrist::PieceKey(Piece piece, Square square)
+{
+    return keys.pieces[piece.GetRaw()][square];
+}
+
+ZobristKey Zobrist::SideKey()
+{
+    return keys.side;
+}
+
+ZobristKey Zobrist::CastlingKey(std::uint8_t rights)
+{
+    return keys.castling[rights];
+}
+
+ZobristKey Zobrist::EnPassantKey(Square square)
+{
+    return keys.en_passant[FileOf(square)];
+}
+} // namespace Game
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Piece/piece.h"
+#include "coordinates.h"
+#include <cstdint>
+
+namespace Game
+{
+using ZobristKey = std::uint64_t;
+
+// Random keys for everything that tells two positions apart. A position's key is the XOR of the
+// keys of all of its parts, so a move only has to XOR in and out whatever it changed
+namespace Zobrist
+{
+[[nodiscard]] ZobristKey PieceKey(Piece piece, Square square);
+// XOR-ed in while black is to move
+[[nodiscard]] ZobristKey SideKey();
+// One key per combination of `CastlingRights`, zero for none at all
+[[nodiscard]] ZobristKey CastlingKey(std::uint8_t rights);
+// Only the file matters, the rank follows from the side to move
+[[nodiscard]] ZobristKey EnPassantKey(Square square);
+} // namespace Zobrist
+} // namespace Game
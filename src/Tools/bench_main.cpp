@@ -0,0 +1,347 @@
+#include "../Game/Piece/king_piece.h"
+#include "../Game/Piece/piece.h"
+#include "../Game/game.h"
+#include "../Game/move_generator.h"
+#include "../Game/position.h"
+#include "../Game/position_snapshot.h"
+#include "../Util/debug.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Usage: chess_bench [--json] [--samples N] [--filter substring]
+// Times the game core's hot paths over a fixed set of positions. Every sample runs the benchmark
+// once over the whole corpus, and the per-operation time of each sample goes into the stats, so
+// runs on two builds can be compared directly (use --json for something diffable).
+
+// Middlegames with plenty of sliders and pins, plus endgames where kings and pawns dominate.
+// Includes positions with castling rights and en passant captures available
+static const char *corpus_fens[] = {
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+    "r2q1rk1/pp2bppp/2n1bn2/2pp4/3P4/2PBPN2/PP1N1PPP/R1BQ1RK1 w - - 0 10",
+    "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "8/8/4k3/3p4/3P4/4K3/8/8 w - - 0 1",
+    "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+    "8/5k2/8/3Q4/8/8/5K2/8 b - - 0 1",
+    "4k3/8/8/8/8/8/4P3/4K2R w K - 0 1",
+    "r3k2r/8/8/8/8/8/8/R3K2R b KQkq - 0 1",
+};
+
+// A fixed opening line, replayed through `Game::MakeMove` from the starting position
+static const Game::Move opening_line[] = {
+    Game::Move(Game::MakeSquare(1, 4), Game::MakeSquare(3, 4)),
+    Game::Move(Game::MakeSquare(6, 4), Game::MakeSquare(4, 4)),
+    Game::Move(Game::MakeSquare(0, 6), Game::MakeSquare(2, 5)),
+    Game::Move(Game::MakeSquare(7, 1), Game::MakeSquare(5, 2)),
+    Game::Move(Game::MakeSquare(0, 5), Game::MakeSquare(4, 1)),
+    Game::Move(Game::MakeSquare(6, 0), Game::MakeSquare(5, 0)),
+    Game::Move(Game::MakeSquare(4, 1), Game::MakeSquare(3, 0)),
+    Game::Move(Game::MakeSquare(7, 6), Game::MakeSquare(5, 5)),
+    Game::Move(Game::MakeSquare(0, 4), Game::MakeSquare(0, 6), Game::MoveFlag::Castle),
+    Game::Move(Game::MakeSquare(7, 5), Game::MakeSquare(6, 4)),
+};
+
+// Written to after every sample so the compiler can't throw the work away
+static volatile std::uint64_t sink;
+#if !defined(__GNUC__) && !defined(__clang__)
+static const void *volatile escape_sink;
+#endif
+
+// For results too big for `sink`: the compiler has to assume all of `value` gets read, so none of
+// the work that filled it in can be skipped
+template <typename T>
+static void do_not_optimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    escape_sink = &value;
+#endif
+}
+
+struct Corpus
+{
+    std::vector<Game::Position> positions;
+    // Legal moves of every position above, so benchmarks playing moves don't time generating them
+    std::vector<Game::MoveList> legal_moves;
+};
+
+struct Benchmark
+{
+    const char *name;
+    // Runs once over the corpus and returns how many operations that was
+    std::uint64_t (*run)(const Corpus &corpus);
+};
+
+struct BenchmarkResult
+{
+    const char *name;
+    std::uint64_t iterations;
+    double min_ns;
+    double median_ns;
+    double p99_ns;
+};
+
+// Pseudo-legal moves of every piece of one type, for both sides
+template <Game::PieceType Type>
+static std::uint64_t bench_possible_moves(const Corpus &corpus)
+{
+    std::uint64_t ops = 0;
+    Game::MoveList moves;
+    for (const auto &position : corpus.positions)
+    {
+        auto pieces = position.GetPieces(Type);
+        while (pieces)
+        {
+            auto square = Game::PopLsb(pieces);
+            moves.Clear();
+            position.GetPieceAt(square)->GetPossibleMoves(position, square, moves);
+            sink = sink + moves.GetSize();
+            ops++;
+        }
+    }
+
+    return ops;
+}
+
+static std::uint64_t bench_legal_moves(const Corpus &corpus)
+{
+    Game::MoveList moves;
+    for (const auto &position : corpus.positions)
+    {
+        moves.Clear();
+        Game::GenerateLegalMoves(position, moves);
+        sink = sink + moves.GetSize();
+    }
+
+    return corpus.positions.size();
+}
+
+static std::uint64_t bench_has_legal_move(const Corpus &corpus)
+{
+    for (const auto &position : corpus.positions)
+    {
+        sink = sink + Game::HasLegalMove(position);
+    }
+
+    return corpus.positions.size();
+}
+
+static std::uint64_t bench_is_in_check(const Corpus &corpus)
+{
+    for (const auto &position : corpus.positions)
+    {
+        sink = sink + Game::KingPiece::IsInCheck(position, Game::Color::White);
+        sink = sink + Game::KingPiece::IsInCheck(position, Game::Color::Black);
+    }
+
+    return corpus.positions.size() * 2;
+}
+
+// Stands in for the old CloneBoard/FreeBoard pair: what it costs to get an independent copy
+static std::uint64_t bench_position_copy(const Corpus &corpus)
+{
+    for (const auto &position : corpus.positions)
+    {
+        auto copy = position;
+        do_not_optimize(copy);
+    }
+
+    return corpus.positions.size();
+}
+
+static std::uint64_t bench_snapshot(const Corpus &corpus)
+{
+    for (const auto &position : corpus.positions)
+    {
+        auto snapshot = Game::PositionSnapshot(position);
+        sink = sink + snapshot->GetHash();
+    }
+
+    return corpus.positions.size();
+}
+
+static std::uint64_t bench_do_undo(const Corpus &corpus)
+{
+    std::uint64_t ops = 0;
+    for (std::size_t i = 0; i < corpus.positions.size(); i++)
+    {
+        auto position = corpus.positions[i];
+        for (auto move : corpus.legal_moves[i])
+        {
+            auto undo = position.DoMove(move);
+            sink = sink + position.GetHash();
+            position.UndoMove(move, undo);
+        }
+
+        ops += corpus.legal_moves[i].GetSize();
+    }
+
+    return ops;
+}
+
+// Includes setting up a new game every time, the line is short enough for that to show
+static std::uint64_t bench_make_move(const Corpus &)
+{
+    Game::Game game;
+    for (auto move : opening_line)
+    {
+        sink = sink + game.MakeMove(move);
+    }
+
+    return std::size(opening_line);
+}
+
+static const Benchmark benchmarks[] = {
+    {"Piece::GetPossibleMoves/pawn", bench_possible_moves<Game::PieceType::Pawn>},
+    {"Piece::GetPossibleMoves/knight", bench_possible_moves<Game::PieceType::Knight>},
+    {"Piece::GetPossibleMoves/bishop", bench_possible_moves<Game::PieceType::Bishop>},
+    {"Piece::GetPossibleMoves/rook", bench_possible_moves<Game::PieceType::Rook>},
+    {"Piece::GetPossibleMoves/queen", bench_possible_moves<Game::PieceType::Queen>},
+    // Includes castling checks, the corpus has castling rights in both directions
+    {"Piece::GetPossibleMoves/king", bench_possible_moves<Game::PieceType::King>},
+    {"GenerateLegalMoves", bench_legal_moves},
+    {"HasLegalMove", bench_has_legal_move},
+    {"KingPiece::IsInCheck", bench_is_in_check},
+    {"Position copy", bench_position_copy},
+    {"PositionSnapshot create", bench_snapshot},
+    {"Position::DoMove+UndoMove", bench_do_undo},
+    {"Game::MakeMove", bench_make_move},
+};
+
+static BenchmarkResult run_benchmark(const Benchmark &benchmark, const Corpus &corpus, int samples)
+{
+    // One untimed pass to warm up caches and lazily initialized state
+    sink = sink + benchmark.run(corpus);
+
+    std::vector<double> per_op;
+    per_op.reserve(samples);
+    std::uint64_t iterations = 0;
+    for (auto i = 0; i < samples; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto ops = benchmark.run(corpus);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        iterations += ops;
+        per_op.push_back(
+            std::chrono::duration<double, std::nano>(elapsed).count() /
+            static_cast<double>(std::max<std::uint64_t>(ops, 1))
+        );
+    }
+
+    std::sort(per_op.begin(), per_op.end());
+    auto percentile = [&per_op](double p) {
+        auto index = static_cast<std::size_t>(p * static_cast<double>(per_op.size() - 1) + 0.5);
+        return per_op[index];
+    };
+
+    return {benchmark.name, iterations, per_op.front(), percentile(0.5), percentile(0.99)};
+}
+
+int main(int argc, char **argv)
+{
+    Util::Debugger::SetDebugEnabled(false);
+
+    auto json = false;
+    auto samples = 200;
+    std::string filter;
+    for (auto i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--json") == 0)
+        {
+            json = true;
+        }
+        else if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+        {
+            samples = std::max(std::atoi(argv[++i]), 1);
+        }
+        else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else
+        {
+            std::fprintf(
+                stderr,
+                "Usage: %s [--json] [--samples N] [--filter substring]\n",
+                argv[0]
+            );
+            return 1;
+        }
+    }
+
+    Corpus corpus;
+    for (auto fen : corpus_fens)
+    {
+        auto position = Game::Position::FromFEN(fen);
+        if (!position.has_value())
+        {
+            std::fprintf(stderr, "Bad corpus FEN: %s\n", fen);
+            return 1;
+        }
+
+        corpus.positions.push_back(position.value());
+        Game::GenerateLegalMoves(position.value(), corpus.legal_moves.emplace_back());
+    }
+
+    std::vector<BenchmarkResult> results;
+    for (const auto &benchmark : benchmarks)
+    {
+        if (filter.empty() || std::string(benchmark.name).find(filter) != std::string::npos)
+        {
+            results.push_back(run_benchmark(benchmark, corpus, samples));
+        }
+    }
+
+    if (json)
+    {
+        std::printf("{\n  \"samples\": %d,\n  \"benchmarks\": [\n", samples);
+        for (std::size_t i = 0; i < results.size(); i++)
+        {
+            const auto &result = results[i];
+            std::printf(
+                "    {\"name\": \"%s\", \"iterations\": %llu, \"min_ns\": %.2f, "
+                "\"median_ns\": %.2f, \"p99_ns\": %.2f}%s\n",
+                result.name,
+                static_cast<unsigned long long>(result.iterations),
+                result.min_ns,
+                result.median_ns,
+                result.p99_ns,
+                i + 1 < results.size() ? "," : ""
+            );
+        }
+        std::printf("  ]\n}\n");
+        return 0;
+    }
+
+    std::printf(
+        "%-34s %12s %10s %10s %10s\n",
+        "benchmark",
+        "iterations",
+        "min ns/op",
+        "median",
+        "p99"
+    );
+    for (const auto &result : results)
+    {
+        std::printf(
+            "%-34s %12llu %10.1f %10.1f %10.1f\n",
+            result.name,
+            static_cast<unsigned long long>(result.iterations),
+            result.min_ns,
+            result.median_ns,
+            result.p99_ns
+        );
+    }
+
+    return 0;
+}
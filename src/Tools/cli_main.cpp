@@ -0,0 +1,281 @@
+#include "../Engine/search.h"
+#include "../Game/game.h"
+#include "../Game/notation.h"
+#include "../Util/debug.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// Headless driver for the rules engine. Reads commands from stdin, one per line:
+//   startpos              start a new game from the initial position
+//   fen <fen>             start a new game from the given position
+//   position              print the current position as FEN
+//   <move> [<move> ...]   play moves in long algebraic notation (e2e4, e7e8q, e1g1 for castling)
+//   go [depth <n>] [nodes <n>] [movetime <ms>]
+//                         search the current position without playing the result. Prints an
+//                         "info depth ..." line per iteration, then "bestmove <move> ..."
+//                         Without any limit, searches to depth 8
+//   hash <mb>             resize the engine's transposition table, which also clears it
+//   threads <n>           search with n threads, 1 by default
+// Every move gets one line of output, either "ok <move> <state>" or "illegal <move>". Moves after
+// an illegal one on the same line are skipped. Output is flushed after every input line, so it can
+// be driven interactively or through a pipe.
+
+static const char *state_name(Game::GameState state)
+{
+    switch (state)
+    {
+        case Game::GameState::Waiting:
+            return "ongoing";
+        case Game::GameState::Ended:
+            return "resigned";
+        case Game::GameState::Draw:
+            return "draw";
+        case Game::GameState::Checkmate:
+            return "checkmate";
+        case Game::GameState::Stalemate:
+            return "stalemate";
+        case Game::GameState::Repetition:
+            return "repetition";
+        case Game::GameState::FiftyMoveRule:
+            return "fifty-move";
+    }
+
+    return "unknown";
+}
+
+// The notation leaves flags like castling and en passant implicit, parsing fills them in from the
+// legal moves
+static bool make_move(Game::Game &game, std::string_view text)
+{
+    auto move = Game::Notation::ParseUCI(game.GetPosition(), text);
+    return move.has_value() && game.MakeMove(move.value());
+}
+
+// Score, depth, nodes, time and principal variation, UCI style
+static void print_search_result(const Engine::SearchResult &result)
+{
+    if (Engine::IsMateScore(result.score))
+    {
+        // In moves rather than plies, negative when getting mated
+        auto plies = Engine::MateScore - std::abs(result.score);
+        auto moves = (plies + 1) / 2;
+        std::cout << "score mate " << (result.score > 0 ? moves : -moves);
+    }
+    else
+    {
+        std::cout << "score cp " << result.score;
+    }
+
+    std::cout << " depth " << result.depth << " nodes " << result.nodes << " time "
+              << result.time.count() << " hashfull " << result.hashfull << " pv";
+    for (auto move : result.pv)
+    {
+        char text[Game::Notation::MaxUCILength];
+        auto end = Game::Notation::WriteUCI(text, text + sizeof(text), move).ptr;
+        std::cout << ' ' << std::string_view(text, static_cast<std::size_t>(end - text));
+    }
+}
+
+// Depth of a "go" without limits. Nothing reads stdin while searching, so an unlimited search
+// could never be stopped
+constexpr int default_go_depth = 8;
+
+// Parses "go" arguments, e.g. "depth 8 movetime 1000". Nothing if one is malformed
+static std::optional<Engine::SearchLimits> parse_limits(std::string_view rest)
+{
+    Engine::SearchLimits limits;
+    while (true)
+    {
+        auto start = rest.find_first_not_of(' ');
+        if (start == std::string_view::npos)
+        {
+            if (limits.depth == 0 && limits.nodes == 0 && limits.time.count() == 0)
+            {
+                limits.depth = default_go_depth;
+            }
+            return limits;
+        }
+        rest.remove_prefix(start);
+
+        auto name = rest.substr(0, rest.find(' '));
+        rest.remove_prefix(name.size());
+        rest.remove_prefix(std::min(rest.find_first_not_of(' '), rest.size()));
+        auto value_text = rest.substr(0, rest.find(' '));
+        rest.remove_prefix(value_text.size());
+
+        std::uint64_t value = 0;
+        auto [end, error] =
+            std::from_chars(value_text.data(), value_text.data() + value_text.size(), value);
+        if (error != std::errc() || end != value_text.data() + value_text.size())
+        {
+            return std::nullopt;
+        }
+
+        // Anything bigger would turn negative as a depth, or overflow the deadline as a time
+        if (name != "nodes" && value > static_cast<std::uint64_t>(std::numeric_limits<int>::max()))
+        {
+            return std::nullopt;
+        }
+
+        if (name == "depth")
+        {
+            limits.depth = static_cast<int>(value);
+        }
+        else if (name == "nodes")
+        {
+            limits.nodes = value;
+        }
+        else if (name == "movetime")
+        {
+            limits.time = std::chrono::milliseconds(value);
+        }
+        else
+        {
+            return std::nullopt;
+        }
+    }
+}
+
+int main()
+{
+    Util::Debugger::SetDebugEnabled(false);
+    std::ios::sync_with_stdio(false);
+
+    auto game = std::make_unique<Game::Game>();
+    auto searcher = std::make_unique<Engine::Searcher>();
+    std::string line;
+    while (std::getline(std::cin, line))
+    {
+        std::string_view rest = line;
+        if (rest.starts_with("fen "))
+        {
+            auto loaded = Game::Game::FromFEN(rest.substr(4));
+            if (loaded != nullptr)
+            {
+                game = std::move(loaded);
+                searcher->Clear();
+                std::cout << "ok fen " << state_name(game->GetState()) << '\n';
+            }
+            else
+            {
+                std::cout << "error invalid fen\n";
+            }
+        }
+        else if (rest == "startpos")
+        {
+            game = std::make_unique<Game::Game>();
+            searcher->Clear();
+            std::cout << "ok startpos\n";
+        }
+        else if (rest.starts_with("hash "))
+        {
+            auto value_text = rest.substr(5);
+            std::size_t size_mb = 0;
+            auto [end, error] =
+                std::from_chars(value_text.data(), value_text.data() + value_text.size(), size_mb);
+            auto valid = error == std::errc() &&
+                         end == value_text.data() + value_text.size() && size_mb > 0;
+            if (!valid)
+            {
+                std::cout << "error invalid hash\n";
+            }
+            else
+            {
+                searcher = std::make_unique<Engine::Searcher>(size_mb, searcher->GetThreadCount());
+                std::cout << "ok hash " << size_mb << '\n';
+            }
+        }
+        else if (rest.starts_with("threads "))
+        {
+            auto value_text = rest.substr(8);
+            int thread_count = 0;
+            auto [end, error] = std::from_chars(
+                value_text.data(), value_text.data() + value_text.size(), thread_count
+            );
+            auto valid = error == std::errc() &&
+                         end == value_text.data() + value_text.size() && thread_count > 0;
+            if (!valid)
+            {
+                std::cout << "error invalid threads\n";
+            }
+            else
+            {
+                searcher->SetThreadCount(thread_count);
+                std::cout << "ok threads " << thread_count << '\n';
+            }
+        }
+        else if (rest == "position")
+        {
+            std::cout << "position " << game->ToFEN() << '\n';
+        }
+        else if (rest == "go" || rest.starts_with("go "))
+        {
+            auto limits = parse_limits(rest.substr(2));
+            if (!limits.has_value())
+            {
+                std::cout << "error invalid go\n";
+                std::cout.flush();
+                continue;
+            }
+
+            auto result =
+                searcher->Search(*game, limits.value(), [](const Engine::SearchResult &iteration) {
+                    std::cout << "info ";
+                    print_search_result(iteration);
+                    std::cout << std::endl;
+                });
+
+            std::cout << "bestmove ";
+            if (result.best_move == Game::Move())
+            {
+                std::cout << "none";
+            }
+            else
+            {
+                char text[Game::Notation::MaxUCILength];
+                auto end = Game::Notation::WriteUCI(text, text + sizeof(text), result.best_move);
+                std::cout << std::string_view(text, static_cast<std::size_t>(end.ptr - text));
+            }
+            std::cout << ' ';
+            print_search_result(result);
+            std::cout << '\n';
+        }
+        else
+        {
+            while (!rest.empty())
+            {
+                auto start = rest.find_first_not_of(' ');
+                if (start == std::string_view::npos)
+                {
+                    break;
+                }
+
+                rest.remove_prefix(start);
+                auto token = rest.substr(0, rest.find(' '));
+                rest.remove_prefix(token.size());
+
+                if (!make_move(*game, token))
+                {
+                    std::cout << "illegal " << token << '\n';
+                    break;
+                }
+
+                std::cout << "ok " << token << ' ' << state_name(game->GetState()) << '\n';
+            }
+        }
+
+        std::cout.flush();
+    }
+
+    return 0;
+}
@@ -0,0 +1,477 @@
+#include "../Engine/search.h"
+#include "../Game/notation.h"
+#include "../Game/perft.h"
+#include "../Game/position.h"
+#include "../Util/debug.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Usage:
+//   chess_epd [-t threads] [-T timeout_s] [-s search_s] [-d max_depth] [-H hash_mb] [-q] <file.epd>
+// Runs every record of an EPD file on a pool of worker threads. Records look like
+//   <4 FEN fields> [clocks] <opcode> <operands>; <opcode> <operands>; ...
+// Perft counts (D1, D2, ...) are checked against move generation, depth by depth, until one is
+// off or the record runs out of time. For `bm`/`am` (best and avoid moves, in SAN), the engine
+// searches for `search_s` seconds, 1 by default, and has to pick one of the best moves and none
+// of the avoided ones. -H sizes both the perft table all workers share, and the search tables of
+// the workers that need one, which split the same budget between them. With -q, only records
+// that didn't pass are listed.
+// Exits with 1 if anything failed, timed out or couldn't be parsed.
+
+namespace
+{
+enum class Outcome
+{
+    Pass,
+    Fail,
+    Timeout,
+    Skipped,
+    Invalid,
+};
+
+struct Record
+{
+    std::size_t line;
+    std::string id;
+    std::string fen;
+    std::optional<Game::Position> position;
+    // (depth, expected nodes), in the order they appear
+    std::vector<std::pair<int, std::uint64_t>> perft;
+    // SAN, as written in the file
+    std::vector<std::string> best_moves;
+    std::vector<std::string> avoid_moves;
+};
+
+struct Result
+{
+    Outcome outcome;
+    std::string detail;
+    std::uint64_t nodes;
+    double seconds;
+};
+
+struct Options
+{
+    int threads;
+    double timeout_s;
+    double search_s;
+    int max_depth;
+    int hash_mb;
+    bool quiet;
+};
+} // namespace
+
+[[nodiscard]] static std::string_view trim(std::string_view text)
+{
+    auto start = text.find_first_not_of(" \t\r\n");
+    if (start == std::string_view::npos)
+    {
+        return {};
+    }
+
+    auto end = text.find_last_not_of(" \t\r\n");
+    return text.substr(start, end - start + 1);
+}
+
+// Splits off the next whitespace separated token
+[[nodiscard]] static std::string_view next_token(std::string_view &rest)
+{
+    rest = trim(rest);
+    auto token = rest.substr(0, rest.find_first_of(" \t"));
+    rest.remove_prefix(token.size());
+    return token;
+}
+
+template <typename T> [[nodiscard]] static std::optional<T> parse_number(std::string_view text)
+{
+    T value{};
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() || end != text.data() + text.size())
+    {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+[[nodiscard]] static Record parse_record(std::string_view line, std::size_t line_number)
+{
+    Record record{line_number, std::to_string(line_number), {}, std::nullopt, {}, {}, {}};
+
+    // Board, side, castling and en passant, then optionally the clocks if the file has full FENs
+    auto rest = line;
+    for (auto i = 0; i < 4; i++)
+    {
+        if (i > 0)
+        {
+            record.fen += ' ';
+        }
+        record.fen += next_token(rest);
+    }
+
+    for (auto i = 0; i < 2; i++)
+    {
+        auto peek = rest;
+        auto token = next_token(peek);
+        if (token.empty() || !parse_number<int>(token).has_value())
+        {
+            break;
+        }
+
+        record.fen += ' ';
+        record.fen += token;
+        rest = peek;
+    }
+
+    record.position = Game::Position::FromFEN(record.fen);
+
+    // Operations are separated by semicolons, some files also start with one
+    while (!rest.empty())
+    {
+        auto end = rest.find(';');
+        auto operation = trim(rest.substr(0, end));
+        rest = end == std::string_view::npos ? std::string_view() : rest.substr(end + 1);
+
+        auto opcode = next_token(operation);
+        auto operands = trim(operation);
+        if (opcode.size() >= 2 && opcode[0] == 'D')
+        {
+            auto depth = parse_number<int>(opcode.substr(1));
+            auto nodes = parse_number<std::uint64_t>(operands);
+            if (depth.has_value() && nodes.has_value())
+            {
+                record.perft.emplace_back(depth.value(), nodes.value());
+            }
+        }
+        else if (opcode == "id")
+        {
+            if (operands.size() >= 2 && operands.front() == '"' && operands.back() == '"')
+            {
+                operands = operands.substr(1, operands.size() - 2);
+            }
+            record.id = operands;
+        }
+        else if (opcode == "bm" || opcode == "am")
+        {
+            auto &moves = opcode == "bm" ? record.best_moves : record.avoid_moves;
+            for (auto move = next_token(operands); !move.empty(); move = next_token(operands))
+            {
+                moves.emplace_back(move);
+            }
+        }
+    }
+
+    return record;
+}
+
+// "D<depth>", as the perft opcodes are called. Built up with appends, GCC 12 warns about
+// `operator+` chains on string literals
+[[nodiscard]] static std::string depth_name(int depth)
+{
+    std::string name = "D";
+    name.append(std::to_string(depth));
+    return name;
+}
+
+// Whether the move is among the given SAN moves. Nothing if one of them isn't a legal move
+[[nodiscard]] static std::optional<bool> is_among(
+    const Game::Position &position, Game::Move move, const std::vector<std::string> &moves
+)
+{
+    auto found = false;
+    for (const auto &text : moves)
+    {
+        auto parsed = Game::Notation::ParseSAN(position, text);
+        if (!parsed.has_value())
+        {
+            return std::nullopt;
+        }
+        found = found || parsed.value() == move;
+    }
+
+    return found;
+}
+
+[[nodiscard]] static Result run_record(
+    const Record &record, const Options &options, Game::PerftTable *table,
+    std::unique_ptr<Engine::Searcher> &searcher
+)
+{
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                std::chrono::duration<double>(options.timeout_s)
+                            );
+    auto elapsed = [&start]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    if (!record.position.has_value())
+    {
+        return {Outcome::Invalid, "invalid FEN", 0, 0};
+    }
+
+    auto needs_search = !record.best_moves.empty() || !record.avoid_moves.empty();
+    if (record.perft.empty() && !needs_search)
+    {
+        return {Outcome::Skipped, "nothing to check", 0, 0};
+    }
+
+    auto position = record.position.value();
+    std::uint64_t total = 0;
+    for (auto [depth, expected] : record.perft)
+    {
+        if (depth > options.max_depth)
+        {
+            continue;
+        }
+
+        auto nodes = Game::Perft(position, depth, deadline, table);
+        if (!nodes.has_value())
+        {
+            return {Outcome::Timeout, depth_name(depth), total, elapsed()};
+        }
+
+        total += nodes.value();
+        if (nodes.value() != expected)
+        {
+            auto detail = depth_name(depth);
+            detail.append(" expected ").append(std::to_string(expected));
+            detail.append(", got ").append(std::to_string(nodes.value()));
+            return {Outcome::Fail, detail, total, elapsed()};
+        }
+    }
+
+    if (!needs_search)
+    {
+        return {Outcome::Pass, {}, total, elapsed()};
+    }
+
+    // Whatever is left of the record's time, if that's less than the search time
+    auto remaining = std::chrono::duration<double>(deadline - std::chrono::steady_clock::now());
+    auto search_time = std::min(options.search_s, remaining.count());
+    Engine::SearchLimits limits;
+    auto search_ms = std::max(static_cast<long long>(search_time * 1000), 1LL);
+    limits.time = std::chrono::milliseconds(search_ms);
+
+    // Perft-only suites never pay for a transposition table per worker
+    if (searcher == nullptr)
+    {
+        auto hash_mb = std::max(options.hash_mb / options.threads, 1);
+        searcher = std::make_unique<Engine::Searcher>(static_cast<std::size_t>(hash_mb));
+    }
+
+    auto result = searcher->Search(position, {}, limits);
+    total += result.nodes;
+
+    auto best = record.best_moves.empty()
+                    ? std::optional<bool>(true)
+                    : is_among(position, result.best_move, record.best_moves);
+    auto avoided = is_among(position, result.best_move, record.avoid_moves);
+    if (!best.has_value() || !avoided.has_value())
+    {
+        return {Outcome::Invalid, "bm/am isn't a legal move", total, elapsed()};
+    }
+
+    if (best.value() && !avoided.value())
+    {
+        return {Outcome::Pass, {}, total, elapsed()};
+    }
+
+    char played[Game::Notation::MaxSANLength];
+    auto end = Game::Notation::WriteSAN(
+        played, played + sizeof(played), position, result.best_move
+    );
+    std::string detail = "played ";
+    detail.append(played, end.ptr).append(" at depth ").append(std::to_string(result.depth));
+    return {Outcome::Fail, detail, total, elapsed()};
+}
+
+static int usage(const char *program)
+{
+    std::fprintf(
+        stderr,
+        "Usage: %s [-t threads] [-T timeout_s] [-s search_s] [-d max_depth] [-H hash_mb] [-q] "
+        "<file.epd>\n",
+        program
+    );
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    Util::Debugger::SetDebugEnabled(false);
+
+    Options options{
+        static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u)),
+        60.0,
+        1.0,
+        64,
+        64,
+        false,
+    };
+
+    const char *path = nullptr;
+    for (auto i = 1; i < argc; i++)
+    {
+        std::string_view arg = argv[i];
+        if (arg == "-q")
+        {
+            options.quiet = true;
+            continue;
+        }
+
+        if (arg.size() == 2 && arg[0] == '-' && i + 1 < argc)
+        {
+            auto value = parse_number<double>(argv[++i]);
+            if (!value.has_value() || value.value() < 0)
+            {
+                return usage(argv[0]);
+            }
+
+            switch (arg[1])
+            {
+                case 't':
+                    options.threads = std::max(static_cast<int>(value.value()), 1);
+                    break;
+                case 'T':
+                    options.timeout_s = value.value();
+                    break;
+                case 's':
+                    options.search_s = value.value();
+                    break;
+                case 'd':
+                    options.max_depth = static_cast<int>(value.value());
+                    break;
+                case 'H':
+                    options.hash_mb = static_cast<int>(value.value());
+                    break;
+                default:
+                    return usage(argv[0]);
+            }
+            continue;
+        }
+
+        if (path != nullptr || arg.starts_with('-'))
+        {
+            return usage(argv[0]);
+        }
+        path = argv[i];
+    }
+
+    if (path == nullptr)
+    {
+        return usage(argv[0]);
+    }
+
+    std::ifstream file(path);
+    if (!file)
+    {
+        std::fprintf(stderr, "Can't open %s\n", path);
+        return 1;
+    }
+
+    std::vector<Record> records;
+    std::string line;
+    for (std::size_t line_number = 1; std::getline(file, line); line_number++)
+    {
+        auto text = trim(line);
+        if (!text.empty() && text[0] != '#')
+        {
+            records.push_back(parse_record(text, line_number));
+        }
+    }
+
+    // Shared by every worker, positions from the same suite tend to share subtrees
+    std::unique_ptr<Game::PerftTable> table;
+    if (options.hash_mb > 0)
+    {
+        table = std::make_unique<Game::PerftTable>(static_cast<std::size_t>(options.hash_mb));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<Result> results(records.size());
+    std::atomic<std::size_t> next_record = 0;
+    auto work = [&]() {
+        // Searchers keep per-search state, so every worker needs its own, made on first use
+        std::unique_ptr<Engine::Searcher> searcher;
+        for (auto i = next_record++; i < records.size(); i = next_record++)
+        {
+            results[i] = run_record(records[i], options, table.get(), searcher);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    auto thread_count =
+        std::min<std::size_t>(options.threads, std::max<std::size_t>(records.size(), 1));
+    for (std::size_t i = 0; i < thread_count; i++)
+    {
+        workers.emplace_back(work);
+    }
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    static const char *outcome_names[] = {"PASS", "FAIL", "TIMEOUT", "SKIP", "INVALID"};
+    std::size_t counts[5] = {};
+    std::uint64_t nodes = 0;
+    for (std::size_t i = 0; i < records.size(); i++)
+    {
+        const auto &result = results[i];
+        auto outcome = static_cast<int>(result.outcome);
+        counts[outcome]++;
+        nodes += result.nodes;
+
+        if (options.quiet && result.outcome == Outcome::Pass)
+        {
+            continue;
+        }
+
+        std::printf(
+            "%-7s line %zu, %s%s%s (%.3f s)\n",
+            outcome_names[outcome],
+            records[i].line,
+            records[i].id.c_str(),
+            result.detail.empty() ? "" : ": ",
+            result.detail.c_str(),
+            result.seconds
+        );
+    }
+
+    std::printf(
+        "\n%zu records: %zu passed, %zu failed, %zu timed out, %zu skipped, %zu invalid\n",
+        records.size(),
+        counts[static_cast<int>(Outcome::Pass)],
+        counts[static_cast<int>(Outcome::Fail)],
+        counts[static_cast<int>(Outcome::Timeout)],
+        counts[static_cast<int>(Outcome::Skipped)],
+        counts[static_cast<int>(Outcome::Invalid)]
+    );
+    std::printf(
+        "%.3f s, %.1f records/s, %.0f nodes/s on %zu threads\n",
+        seconds,
+        seconds > 0 ? static_cast<double>(records.size()) / seconds : 0.0,
+        seconds > 0 ? static_cast<double>(nodes) / seconds : 0.0,
+        thread_count
+    );
+
+    auto failed = counts[static_cast<int>(Outcome::Fail)] +
+                  counts[static_cast<int>(Outcome::Timeout)] +
+                  counts[static_cast<int>(Outcome::Invalid)];
+    return failed > 0 ? 1 : 0;
+}
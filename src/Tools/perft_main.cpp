@@ -0,0 +1,131 @@
+#include "../Game/notation.h"
+#include "../Game/perft.h"
+#include "../Game/position.h"
+#include "../Util/debug.h"
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <thread>
+
+// Usage: chess_perft [-t threads] [-H hash_mb] <depth> [fen]
+// Prints the node count below every root move ("divide"), then the total and how fast it went.
+// The FEN may be passed as one argument or as several, it's joined back together either way.
+// Threads default to one per core and the hash table to 64 MB, `-H 0` turns it off.
+
+static std::optional<int> parse_int(const char *text)
+{
+    int value = 0;
+    auto end = text + std::strlen(text);
+    auto [parsed_end, error] = std::from_chars(text, end, value);
+    if (error != std::errc() || parsed_end != end)
+    {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+static int usage(const char *program)
+{
+    std::fprintf(stderr, "Usage: %s [-t threads] [-H hash_mb] <depth> [fen]\n", program);
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    Util::Debugger::SetDebugEnabled(false);
+
+    auto threads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+    auto hash_mb = 64;
+
+    auto arg = 1;
+    for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2)
+    {
+        auto value = parse_int(argv[arg + 1]);
+        if (!value.has_value() || value.value() < 0)
+        {
+            return usage(argv[0]);
+        }
+
+        if (std::strcmp(argv[arg], "-t") == 0)
+        {
+            threads = std::max(value.value(), 1);
+        }
+        else if (std::strcmp(argv[arg], "-H") == 0)
+        {
+            hash_mb = value.value();
+        }
+        else
+        {
+            return usage(argv[0]);
+        }
+    }
+
+    if (arg >= argc)
+    {
+        return usage(argv[0]);
+    }
+
+    auto depth = parse_int(argv[arg]);
+    if (!depth.has_value() || depth.value() < 1)
+    {
+        std::fprintf(stderr, "Invalid depth: %s\n", argv[arg]);
+        return 1;
+    }
+
+    auto position = Game::Position::StartingPosition();
+    if (++arg < argc)
+    {
+        std::string fen = argv[arg];
+        while (++arg < argc)
+        {
+            fen += ' ';
+            fen += argv[arg];
+        }
+
+        auto parsed = Game::Position::FromFEN(fen);
+        if (!parsed.has_value())
+        {
+            std::fprintf(stderr, "Invalid FEN: %s\n", fen.c_str());
+            return 1;
+        }
+
+        position = parsed.value();
+    }
+
+    std::unique_ptr<Game::PerftTable> table;
+    if (hash_mb > 0)
+    {
+        table = std::make_unique<Game::PerftTable>(static_cast<std::size_t>(hash_mb));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto divisions = Game::ParallelPerftDivide(position, depth.value(), threads, table.get());
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    std::uint64_t nodes = 0;
+    for (const auto &division : divisions)
+    {
+        char move[Game::Notation::MaxUCILength];
+        auto end = Game::Notation::WriteUCI(move, move + sizeof(move), division.move).ptr;
+        std::printf(
+            "%.*s: %llu\n",
+            static_cast<int>(end - move),
+            move,
+            static_cast<unsigned long long>(division.nodes)
+        );
+        nodes += division.nodes;
+    }
+
+    auto seconds = std::chrono::duration<double>(elapsed).count();
+    std::printf("\nMoves: %zu\n", divisions.size());
+    std::printf("Nodes: %llu\n", static_cast<unsigned long long>(nodes));
+    std::printf("Time: %.3f s\n", seconds);
+    std::printf("NPS: %.0f\n", seconds > 0 ? static_cast<double>(nodes) / seconds : 0.0);
+    std::printf("Threads: %d, hash: %d MB\n", threads, hash_mb);
+
+    return 0;
+}
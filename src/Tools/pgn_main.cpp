@@ -0,0 +1,133 @@
+#include "../Game/pgn.h"
+#include "../Util/debug.h"
+#include "../Util/mapped_file.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Usage: chess_pgn [-t threads] [-v] <file.pgn>
+// Replays every game of a PGN file through `Game::MakeMove` and reports how many games and moves
+// were read and how fast. With -v, every game that couldn't be replayed is listed with its byte
+// offset in the file. Exits with 1 if any game couldn't be replayed.
+
+static std::optional<int> parse_int(const char *text)
+{
+    int value = 0;
+    auto end = text + std::strlen(text);
+    auto [parsed_end, error] = std::from_chars(text, end, value);
+    if (error != std::errc() || parsed_end != end)
+    {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+static int usage(const char *program)
+{
+    std::fprintf(stderr, "Usage: %s [-t threads] [-v] <file.pgn>\n", program);
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    Util::Debugger::SetDebugEnabled(false);
+
+    auto threads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+    auto verbose = false;
+    const char *path = nullptr;
+    for (auto i = 1; i < argc; i++)
+    {
+        std::string_view arg = argv[i];
+        if (arg == "-v")
+        {
+            verbose = true;
+        }
+        else if (arg == "-t" && i + 1 < argc)
+        {
+            auto value = parse_int(argv[++i]);
+            if (!value.has_value() || value.value() < 1)
+            {
+                return usage(argv[0]);
+            }
+            threads = value.value();
+        }
+        else if (path == nullptr && !arg.starts_with('-'))
+        {
+            path = argv[i];
+        }
+        else
+        {
+            return usage(argv[0]);
+        }
+    }
+
+    if (path == nullptr)
+    {
+        return usage(argv[0]);
+    }
+
+    auto file = Util::MappedFile::Open(path);
+    if (file == nullptr)
+    {
+        std::fprintf(stderr, "Can't open %s\n", path);
+        return 1;
+    }
+
+    auto text = file->GetContents();
+    auto start = std::chrono::steady_clock::now();
+
+    std::atomic<std::uint64_t> games = 0;
+    std::atomic<std::uint64_t> plies = 0;
+    std::mutex errors_mutex;
+    std::vector<std::pair<std::size_t, std::string>> errors;
+    Game::ParsePgnGames(text, threads, [&](Game::PgnGame &game) {
+        games.fetch_add(1, std::memory_order_relaxed);
+        if (game.game != nullptr)
+        {
+            plies.fetch_add(game.game->GetMoves().size(), std::memory_order_relaxed);
+        }
+
+        if (!game.error.empty())
+        {
+            std::lock_guard lock(errors_mutex);
+            errors.emplace_back(game.offset, std::move(game.error));
+        }
+    });
+
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (verbose)
+    {
+        std::sort(errors.begin(), errors.end());
+        for (const auto &[offset, error] : errors)
+        {
+            std::printf("game at byte %zu: %s\n", offset, error.c_str());
+        }
+    }
+
+    std::printf(
+        "%llu games, %llu plies, %zu with errors\n",
+        static_cast<unsigned long long>(games.load()),
+        static_cast<unsigned long long>(plies.load()),
+        errors.size()
+    );
+    std::printf(
+        "%.3f s, %.1f MB/s, %.0f games/s on %d threads\n",
+        seconds,
+        seconds > 0 ? static_cast<double>(text.size()) / (1024 * 1024) / seconds : 0.0,
+        seconds > 0 ? static_cast<double>(games.load()) / seconds : 0.0,
+        threads
+    );
+
+    return errors.empty() ? 0 : 1;
+}
@@ -11,7 +11,7 @@ ScopedDebugger::ScopedDebugger(const char *scope) : m_scope(scope)
 {
 }
 
-void ScopedDebugger::Debug(const char *format, ...)
+void ScopedDebugger::Debug([[maybe_unused]] const char *format, ...)
 {
 #ifndef NDEBUG
     if (!Debugger::s_debug_enabled)
@@ -26,7 +26,8 @@ void ScopedDebugger::Debug(const char *format, ...)
     auto buffer_size = scope_len + format_len + 4;
     std::vector<char> buffer(buffer_size);
 
-    auto written = std::snprintf(buffer.data(), buffer_size, "[%s] %s", m_scope, format);
+    [[maybe_unused]] auto written =
+        std::snprintf(buffer.data(), buffer_size, "[%s] %s", m_scope, format);
     assert(written > 0 && static_cast<unsigned long>(written) < buffer_size);
 
     va_list args;
@@ -42,14 +43,14 @@ void ScopedDebugger::Debug(const char *format, ...)
 bool Debugger::s_debug_enabled = true;
 #endif
 
-void Debugger::SetDebugEnabled(bool enabled)
+void Debugger::SetDebugEnabled([[maybe_unused]] bool enabled)
 {
 #ifndef NDEBUG
     s_debug_enabled = enabled;
 #endif
 }
 
-void Debugger::Debug(const char *format, ...)
+void Debugger::Debug([[maybe_unused]] const char *format, ...)
 {
 #ifndef NDEBUG
     if (!s_debug_enabled)
@@ -73,12 +74,16 @@ ScopedDebugger Debugger::CreateScope(const char *scope)
 
 void Debugger::_Write(const char *format, va_list args)
 {
-    auto required_size_without_prefix = std::vsnprintf(NULL, 0, format, args);
+    // Measuring consumes the arguments, so it gets its own copy of them
+    va_list measure_args;
+    va_copy(measure_args, args);
+    auto required_size_without_prefix = std::vsnprintf(NULL, 0, format, measure_args);
+    va_end(measure_args);
 
     auto buffer_size = s_debug_prefix_len + required_size_without_prefix + 1;
     std::vector<char> buffer(buffer_size);
-    std::strncpy(buffer.data(), s_debug_prefix, s_debug_prefix_len);
-    auto written = std::vsnprintf(
+    std::memcpy(buffer.data(), s_debug_prefix, s_debug_prefix_len);
+    [[maybe_unused]] auto written = std::vsnprintf(
         buffer.data() + s_debug_prefix_len,
         buffer_size - s_debug_prefix_len,
         format,
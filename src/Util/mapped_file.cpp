@@ -0,0 +1,155 @@
+#include "mapped_file.h"
+#include "debug.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Util
+{
+MappedFile::MappedFile()
+    : m_data(nullptr),
+      m_size(0)
+#ifdef _WIN32
+      ,
+      m_file(INVALID_HANDLE_VALUE),
+      m_mapping(nullptr)
+#endif
+{
+}
+
+#ifdef _WIN32
+std::unique_ptr<MappedFile> MappedFile::Open(const char *path)
+{
+    auto debugger = Debugger::CreateScope("MappedFile::Open");
+
+    std::unique_ptr<MappedFile> file(new MappedFile());
+    file->m_file = CreateFileA(
+        path,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr
+    );
+    if (file->m_file == INVALID_HANDLE_VALUE)
+    {
+        debugger.Debug("Can't open %s\n", path);
+        return nullptr;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file->m_file, &size))
+    {
+        debugger.Debug("Can't get the size of %s\n", path);
+        return nullptr;
+    }
+
+    // Empty files can't be mapped, but there's nothing to read anyway
+    file->m_size = static_cast<std::size_t>(size.QuadPart);
+    if (file->m_size == 0)
+    {
+        return file;
+    }
+
+    file->m_mapping = CreateFileMappingA(file->m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (file->m_mapping == nullptr)
+    {
+        debugger.Debug("Can't map %s\n", path);
+        return nullptr;
+    }
+
+    file->m_data =
+        static_cast<const char *>(MapViewOfFile(file->m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (file->m_data == nullptr)
+    {
+        debugger.Debug("Can't map %s\n", path);
+        return nullptr;
+    }
+
+    return file;
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data != nullptr)
+    {
+        UnmapViewOfFile(m_data);
+    }
+
+    if (m_mapping != nullptr)
+    {
+        CloseHandle(m_mapping);
+    }
+
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_file);
+    }
+}
+#else
+std::unique_ptr<MappedFile> MappedFile::Open(const char *path)
+{
+    auto debugger = Debugger::CreateScope("MappedFile::Open");
+
+    auto fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        debugger.Debug("Can't open %s\n", path);
+        return nullptr;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        debugger.Debug("Can't get the size of %s\n", path);
+        close(fd);
+        return nullptr;
+    }
+
+    // Empty files can't be mapped, but there's nothing to read anyway
+    std::unique_ptr<MappedFile> file(new MappedFile());
+    file->m_size = static_cast<std::size_t>(info.st_size);
+    if (file->m_size == 0)
+    {
+        close(fd);
+        return file;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    auto data = mmap(nullptr, file->m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        debugger.Debug("Can't map %s\n", path);
+        return nullptr;
+    }
+
+    // Readers go front to back through their part of the file, so let the kernel read ahead
+    madvise(data, file->m_size, MADV_SEQUENTIAL);
+    file->m_data = static_cast<const char *>(data);
+
+    return file;
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data != nullptr)
+    {
+        munmap(const_cast<char *>(m_data), m_size);
+    }
+}
+#endif
+
+std::string_view MappedFile::GetContents() const
+{
+    return {m_data, m_size};
+}
+} // namespace Util
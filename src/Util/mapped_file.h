@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+namespace Util
+{
+// Read-only view of a whole file, mapped into memory instead of read into a buffer. Pages are
+// loaded by the OS as they're touched, so multi-gigabyte files cost neither a copy nor the
+// memory up front, and any number of threads can read the contents at once
+class MappedFile
+{
+  public:
+    // Null if the file can't be opened or mapped
+    [[nodiscard]] static std::unique_ptr<MappedFile> Open(const char *path);
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile();
+
+    // Valid for as long as the file stays open
+    [[nodiscard]] std::string_view GetContents() const;
+
+  private:
+    const char *m_data;
+    std::size_t m_size;
+#ifdef _WIN32
+    void *m_file;
+    void *m_mapping;
+#endif
+
+    MappedFile();
+};
+} // namespace Util